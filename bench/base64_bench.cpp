@@ -0,0 +1,133 @@
+/**
+ * @file base64_bench.cpp
+ * b64_decode_fast vs mbedtls_base64_decode: differential check, then timing
+ *
+ * Usage: base64_bench [-n iterations]
+ * The differential pass runs first and the benchmark refuses to time
+ * anything if the two decoders disagree (exit code 1). Inputs are always
+ * padded and whitespace-free, which is all the server sends; the fast
+ * decoder rejects anything else by design.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mbedtls/base64.h"
+
+#include "base64_fast.h"
+#include "bench_common.h"
+#include "data_model.h"
+
+static std::string encode(const std::vector<uint8_t> &raw) {
+    size_t olen = 0;
+    mbedtls_base64_encode(nullptr, 0, &olen, raw.data(), raw.size());
+    std::string out(olen, '\0');
+    mbedtls_base64_encode((unsigned char *)&out[0], olen, &olen, raw.data(), raw.size());
+    out.resize(olen);  // olen excludes the terminating NUL
+    return out;
+}
+
+// Both decoders must agree on success, length and bytes
+static bool agree(const std::string &in, size_t cap, const char *what) {
+    std::vector<uint8_t> a(cap + 1), b(cap + 1);
+    size_t alen = 0, blen = 0;
+    int ret = mbedtls_base64_decode(a.data(), cap, &alen, (const unsigned char *)in.data(), in.size());
+    bool ok = b64_decode_fast(in.data(), in.size(), b.data(), cap, &blen);
+
+    bool same = (ret == 0) == ok;
+    if (same && ok) same = alen == blen && memcmp(a.data(), b.data(), alen) == 0;
+    if (!same) {
+        fprintf(stderr, "MISMATCH (%s): len=%zu cap=%zu mbedtls ret=%d len=%zu, fast ok=%d len=%zu\n",
+                what, in.size(), cap, ret, alen, ok, blen);
+    }
+    return same;
+}
+
+static bool differential(std::mt19937 &rng) {
+    static const char kJunk[] = "=-_.!*~@#\x80\xff";
+    std::uniform_int_distribution<int> byte(0, 255);
+    size_t cases = 0;
+
+    for (size_t len = 0; len < 300; ++len) {
+        std::vector<uint8_t> raw(len);
+        for (uint8_t &v : raw) v = (uint8_t)byte(rng);
+        std::string enc = encode(raw);
+
+        // Valid input, exact and oversized output buffers, and a too-small one
+        if (!agree(enc, len, "exact")) return false;
+        if (!agree(enc, len + 7, "roomy")) return false;
+        if (len > 0 && !agree(enc, len - 1, "short")) return false;
+        cases += 3;
+
+        if (enc.empty()) continue;
+
+        // One corrupted character at every position
+        for (size_t pos = 0; pos < enc.size(); pos += 1 + len / 16) {
+            std::string bad = enc;
+            bad[pos] = kJunk[pos % (sizeof(kJunk) - 1)];
+            if (!agree(bad, len + 3, "corrupt")) return false;
+            cases++;
+        }
+
+        // Unpadded lengths: mbedtls 2.x silently drops the partial quad, the
+        // fast decoder is strict and must reject them
+        std::string cut = enc.substr(0, enc.size() - 1);
+        std::vector<uint8_t> tmp(len + 3);
+        size_t tlen = 0;
+        if (b64_decode_fast(cut.data(), cut.size(), tmp.data(), tmp.size(), &tlen)) {
+            fprintf(stderr, "MISMATCH (truncated): len=%zu accepted\n", cut.size());
+            return false;
+        }
+        cases++;
+    }
+
+    // Full-size artwork payloads
+    for (int i = 0; i < 16; ++i) {
+        std::vector<uint8_t> raw(ARTWORK_RGB565_SIZE);
+        for (uint8_t &v : raw) v = (uint8_t)byte(rng);
+        if (!agree(encode(raw), ARTWORK_RGB565_SIZE, "artwork")) return false;
+        cases++;
+    }
+
+    printf("differential: %zu cases, decoders agree\n", cases);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    int iterations = 2000;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) iterations = atoi(argv[++i]);
+    }
+    if (iterations < 1) iterations = 1;
+
+    std::mt19937 rng(27);
+    if (!differential(rng)) return 1;
+
+    std::vector<uint8_t> raw(ARTWORK_RGB565_SIZE);
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (uint8_t &v : raw) v = (uint8_t)byte(rng);
+    std::string enc = encode(raw);
+    std::vector<uint8_t> out(ARTWORK_RGB565_SIZE);
+    size_t olen = 0;
+
+    uint64_t t0 = bench_now_ns();
+    for (int i = 0; i < iterations; ++i) {
+        mbedtls_base64_decode(out.data(), out.size(), &olen, (const unsigned char *)enc.data(), enc.size());
+    }
+    uint64_t t1 = bench_now_ns();
+    for (int i = 0; i < iterations; ++i) {
+        b64_decode_fast(enc.data(), enc.size(), out.data(), out.size(), &olen);
+    }
+    uint64_t t2 = bench_now_ns();
+
+    double mbedUs = (t1 - t0) / 1e3 / iterations;
+    double fastUs = (t2 - t1) / 1e3 / iterations;
+    printf("artwork payload: %zu chars -> %d bytes, %d iterations\n", enc.size(), ARTWORK_RGB565_SIZE, iterations);
+    printf("  mbedtls_base64_decode %8.2f us/artwork  %8.1f MB/s\n", mbedUs, enc.size() / mbedUs);
+    printf("  b64_decode_fast       %8.2f us/artwork  %8.1f MB/s  (%.1fx)\n", fastUs, enc.size() / fastUs, mbedUs / fastUs);
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file bench_common.cpp
+ * Allocation hooks and helpers shared by the host-side benchmarks
+ *
+ * C++ allocations are counted by replacing the global operator new; C
+ * allocations made from our own objects (ArduinoJson's DynamicJsonDocument)
+ * are counted through the linker's --wrap=malloc/calloc/realloc.
+ */
+
+#include "bench_common.h"
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include <chrono>
+#include <fstream>
+#include <new>
+
+HostSerial Serial;
+
+static AllocStats gAllocStats = {0, 0};
+
+static inline void count_alloc(size_t size) {
+    gAllocStats.count++;
+    gAllocStats.bytes += size;
+}
+
+AllocStats bench_alloc_snapshot() {
+    return gAllocStats;
+}
+
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    count_alloc(size);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+    count_alloc(n * size);
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    count_alloc(size);
+    return __real_realloc(ptr, size);
+}
+}
+
+void *operator new(size_t size) {
+    count_alloc(size);
+    void *p = __real_malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+bool bench_load_lines(const char *path, std::vector<std::string> &lines) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty()) lines.push_back(line);
+    }
+    return true;
+}
+
+uint64_t bench_now_ns() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
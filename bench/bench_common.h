@@ -0,0 +1,26 @@
+/**
+ * @file bench_common.h
+ * Shared helpers for the host-side benchmarks: allocation counters,
+ * corpus loading and a monotonic clock.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Incremented by the operator new / malloc hooks in bench_common.cpp
+struct AllocStats {
+    uint64_t count;
+    uint64_t bytes;
+};
+
+AllocStats bench_alloc_snapshot();
+
+// One entry per non-empty line, trailing '\r' stripped (same framing as the ingest tasks)
+bool bench_load_lines(const char *path, std::vector<std::string> &lines);
+
+// Monotonic time in nanoseconds
+uint64_t bench_now_ns();
@@ -0,0 +1,134 @@
+/**
+ * @file parser_bench.cpp
+ * Host benchmark for parse_json_into_msg over recorded server payloads
+ *
+ * Usage: parser_bench [-n iterations] [-v] [corpus.jsonl ...]
+ * With no files the default corpus in bench/corpus/ is used. Each file is
+ * reported separately: messages/sec, bytes/sec and heap allocations per
+ * message (C++ new + malloc family, see bench_common.cpp).
+ */
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "art_tiles.h"
+#include "artwork_cache.h"
+#include "bench_common.h"
+#include "snapshot_parser.h"
+
+// Acks are posted to the UI mailbox; nothing to draw on the host
+bool ui_event_post(UiEventType type, int32_t value) {
+    (void)type;
+    (void)value;
+    return true;
+}
+
+// No flash and no server on the host: every key misses, replies go nowhere
+bool artwork_cache_valid_key(const char* key) {
+    return key[0] != '\0';
+}
+
+bool artwork_cache_load(const char* key, uint8_t* dst) {
+    (void)key;
+    (void)dst;
+    return false;
+}
+
+void artwork_cache_store(const char* key, const uint8_t* image) {
+    (void)key;
+    (void)image;
+}
+
+void send_reply(const char* msg) {
+    (void)msg;
+}
+
+// The ambient view is never open on the host
+bool art_tiles_begin(int w, int h) {
+    (void)w;
+    (void)h;
+    return false;
+}
+
+bool art_tiles_put(int x, int y, int w, int h, const char* b64, size_t b64Len, bool jpeg) {
+    (void)x;
+    (void)y;
+    (void)w;
+    (void)h;
+    (void)b64;
+    (void)b64Len;
+    (void)jpeg;
+    return false;
+}
+
+static const char *kDefaultCorpus[] = {
+    "corpus/snapshots.jsonl",
+    "corpus/discord.jsonl",
+    "corpus/acks.jsonl",
+    "corpus/artwork.jsonl",
+};
+
+static void run_file(const char *path, int iterations) {
+    std::vector<std::string> raw;
+    if (!bench_load_lines(path, raw) || raw.empty()) {
+        fprintf(stderr, "%s: no lines\n", path);
+        return;
+    }
+
+    // Lines arrive in a String on the device; build them outside the timed loop
+    std::vector<String> lines;
+    size_t bytesPerPass = 0;
+    for (const std::string &l : raw) {
+        lines.push_back(String(l.c_str(), l.size()));
+        bytesPerPass += l.size();
+    }
+
+    // Warm-up pass (also primes artwork hash state)
+    SnapshotMsg msg;
+    for (const String &l : lines) parse_json_into_msg(l, msg);
+
+    uint32_t queued = 0;
+    AllocStats a0 = bench_alloc_snapshot();
+    uint64_t t0 = bench_now_ns();
+    for (int it = 0; it < iterations; ++it) {
+        for (const String &l : lines) {
+            if (parse_json_into_msg(l, msg)) queued++;
+        }
+    }
+    uint64_t t1 = bench_now_ns();
+    AllocStats a1 = bench_alloc_snapshot();
+
+    double secs = (t1 - t0) / 1e9;
+    double msgs = (double)lines.size() * iterations;
+    printf("%-26s %5zu lines  %10.0f msg/s  %8.2f MB/s  %6.1f allocs/msg  %8.0f alloc B/msg  %3.0f%% queued\n",
+           path, lines.size(),
+           msgs / secs,
+           (double)bytesPerPass * iterations / secs / 1e6,
+           (a1.count - a0.count) / msgs,
+           (a1.bytes - a0.bytes) / msgs,
+           100.0 * queued / msgs);
+}
+
+int main(int argc, char **argv) {
+    int iterations = 200;
+    std::vector<const char *> files;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-v") == 0) {
+            Serial.echo = true;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+    if (iterations < 1) iterations = 1;
+    if (files.empty()) {
+        for (const char *f : kDefaultCorpus) files.push_back(f);
+    }
+
+    printf("parse_json_into_msg, %d iterations per file\n", iterations);
+    for (const char *f : files) run_file(f, iterations);
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file Arduino.h
+ * Minimal host shim of the Arduino core for the bench/ builds
+ *
+ * Only what snapshot_parser.cpp / artwork.cpp touch: a std::string backed
+ * String, a Serial that swallows output, and millis()/micros().
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <string>
+
+class String {
+public:
+    String() {}
+    String(const char *s) : _s(s ? s : "") {}
+    String(const char *s, size_t n) : _s(s, n) {}
+    String(const String &o) : _s(o._s) {}
+    explicit String(char c) : _s(1, c) {}
+    explicit String(int v) : _s(std::to_string(v)) {}
+
+    String &operator=(const String &o) { _s = o._s; return *this; }
+    String &operator=(const char *s) { _s = s ? s : ""; return *this; }
+
+    unsigned int length() const { return (unsigned int)_s.size(); }
+    const char *c_str() const { return _s.c_str(); }
+    void reserve(unsigned int n) { _s.reserve(n); }
+
+    bool concat(const char *s) { _s += s; return true; }
+    bool concat(char c) { _s += c; return true; }
+    String &operator+=(const char *s) { _s += s; return *this; }
+    String &operator+=(char c) { _s += c; return *this; }
+    String &operator+=(const String &o) { _s += o._s; return *this; }
+
+    int indexOf(char c, unsigned int from = 0) const { return find(std::string(1, c), from); }
+    int indexOf(const char *s, unsigned int from = 0) const { return find(s, from); }
+    int indexOf(const String &s, unsigned int from = 0) const { return find(s._s, from); }
+
+    void remove(unsigned int index, unsigned int count) {
+        if (index < _s.size()) _s.erase(index, count);
+    }
+    void trim() {
+        size_t b = _s.find_first_not_of(" \t\r\n");
+        size_t e = _s.find_last_not_of(" \t\r\n");
+        _s = (b == std::string::npos) ? std::string() : _s.substr(b, e - b + 1);
+    }
+
+    bool operator==(const String &o) const { return _s == o._s; }
+    bool operator==(const char *s) const { return _s == (s ? s : ""); }
+    bool operator!=(const String &o) const { return _s != o._s; }
+    bool operator!=(const char *s) const { return !(*this == s); }
+
+private:
+    int find(const std::string &needle, unsigned int from) const {
+        size_t pos = _s.find(needle, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+
+    std::string _s;
+};
+
+// ArduinoJson's String adapter also matches this type
+class StringSumHelper : public String {};
+
+// Serial output is discarded so logging does not dominate measurements
+class HostSerial {
+public:
+    int printf(const char *fmt, ...) {
+        if (!echo) return 0;
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vfprintf(stderr, fmt, ap);
+        va_end(ap);
+        return n;
+    }
+    size_t print(const char *s) { return echo ? fputs(s, stderr), strlen(s) : 0; }
+    size_t print(int v) { return echo ? fprintf(stderr, "%d", v) : 0; }
+    size_t println(const char *s = "") { return echo ? fprintf(stderr, "%s\n", s) : 0; }
+    size_t println(int v) { return echo ? fprintf(stderr, "%d\n", v) : 0; }
+
+    bool echo = false;
+};
+
+extern HostSerial Serial;
+
+inline uint32_t millis() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+inline uint32_t micros() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
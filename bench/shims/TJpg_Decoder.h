@@ -0,0 +1,28 @@
+// Host shim: the JPEG decoder only exists in the firmware build; every call
+// reports an unsupported format so JPEG lines are measured up to the decode
+#pragma once
+#include <stdint.h>
+
+typedef enum {
+    JDR_OK = 0, JDR_INTR, JDR_INP, JDR_MEM1, JDR_MEM2, JDR_PAR, JDR_FMT1, JDR_FMT2, JDR_FMT3
+} JRESULT;
+
+typedef bool (*SketchCallback)(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t *data);
+
+class TJpg_Decoder {
+public:
+    void setJpgScale(uint8_t scale) { (void)scale; }
+    void setSwapBytes(bool swap) { (void)swap; }
+    void setCallback(SketchCallback cb) { (void)cb; }
+    JRESULT getJpgSize(uint16_t *w, uint16_t *h, const uint8_t *data, uint32_t size) {
+        (void)data; (void)size;
+        *w = *h = 0;
+        return JDR_FMT3;
+    }
+    JRESULT drawJpg(int32_t x, int32_t y, const uint8_t *data, uint32_t size) {
+        (void)x; (void)y; (void)data; (void)size;
+        return JDR_FMT3;
+    }
+};
+
+inline TJpg_Decoder TJpgDec;
@@ -0,0 +1,17 @@
+/**
+ * @file esp_rom_crc.h
+ * Host stand-in for the ESP32 ROM CRC routine (bitwise, same result as zlib crc32)
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *buf++;
+        for (int k = 0; k < 8; ++k) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
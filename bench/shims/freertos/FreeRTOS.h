@@ -0,0 +1,8 @@
+// Host shim: only the types data_model.h refers to
+#pragma once
+#include <stdint.h>
+
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+#define pdTRUE  1
+#define pdFALSE 0
@@ -0,0 +1,5 @@
+// Host shim: queues are never created in the bench builds
+#pragma once
+#include "FreeRTOS.h"
+
+typedef void *QueueHandle_t;
@@ -0,0 +1,2 @@
+// Host shim: ui.h includes lvgl.h but the parser only needs its declarations
+#pragma once
@@ -53,6 +53,9 @@
 /* Draw configuration: use built-in software renderer */
 #define LV_USE_DRAW_SW 1
 
+/* Observer subjects: ui.cpp binds its widgets to model values */
+#define LV_USE_OBSERVER 1
+
 /* Keep additional features out: keep defaults in lv_conf_internal.h */
 
 #endif /*LV_CONF_H*/
@@ -0,0 +1,148 @@
+/**
+ * @file art_fx.cpp
+ * Colors and effects derived from the decoded artwork
+ *
+ * Run by the UI once per new image (update_artwork), never per frame, and
+ * in integer arithmetic only. The I8 image's palette is first turned into
+ * an RGB565 lookup table. The accent color samples a 20x20 grid of the
+ * cover into a 512-bin (3-3-3 bit) histogram weighted by saturation, so a
+ * colorful detail can beat a large gray background. About 400 samples,
+ * a few microseconds on the ESP32.
+ *
+ * The backdrop is 1000 pixels: the resampler averages the cover down, then
+ * two running-sum box blur passes (rows, then columns) smooth it, the
+ * second one folding the darkening into its fixed-point reciprocal.
+ */
+
+#include "art_fx.h"
+#include "data_model.h"
+#include "resample.h"
+
+#define ACCENT_STEP 4           // Sample every 4th pixel in x and y
+#define ACCENT_MIN_CHROMA 24    // max - min channel (8-bit) below this counts as gray
+#define ACCENT_MIN_LEVEL 40     // Skip near-black samples
+#define ACCENT_LIFT 180         // Dark accents are scaled up until their brightest channel reaches this
+
+#define BACKDROP_BLUR_R 2         // Box radius, in backdrop pixels (each is 8x8 on screen)
+#define BACKDROP_DIM 96           // Brightness kept, /256
+
+static uint16_t gHist[512];
+static uint16_t gLut[256];       // Palette of the image being processed, as native RGB565
+static Resampler gBackdropResampler;
+
+// I8 artwork palette (lv_color32_t: blue, green, red, alpha) -> gLut
+static void load_palette(const uint8_t* image) {
+    for (int i = 0; i < 256; ++i) {
+        const uint8_t* c = image + i * 4;
+        gLut[i] = (uint16_t)(((c[2] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[0] >> 3));
+    }
+}
+
+// Native RGB565 -> 8-bit channels (replicating the high bits)
+static inline void unpack565(uint16_t p, int &r, int &g, int &b) {
+    r = ((p >> 11) << 3) | (p >> 13);
+    g = (((p >> 5) & 0x3F) << 2) | ((p >> 9) & 0x03);
+    b = ((p & 0x1F) << 3) | ((p >> 2) & 0x07);
+}
+
+// Histogram bin of a sample, or -1 if it is too gray or too dark to be an accent
+static inline int accent_bin(uint16_t p, int &r, int &g, int &b, int &chroma) {
+    unpack565(p, r, g, b);
+    int mx = r > g ? (r > b ? r : b) : (g > b ? g : b);
+    int mn = r < g ? (r < b ? r : b) : (g < b ? g : b);
+    chroma = mx - mn;
+    if (chroma < ACCENT_MIN_CHROMA || mx < ACCENT_MIN_LEVEL) return -1;
+    return ((r >> 5) << 6) | ((g >> 5) << 3) | (b >> 5);
+}
+
+uint32_t art_fx_accent(const uint8_t* image, uint32_t fallback) {
+    load_palette(image);
+    const uint8_t* px = image + ARTWORK_PALETTE_SIZE;
+    int r, g, b, chroma;
+
+    // Weight 3..31 per sample: at most 400 * 31, fits the 16-bit bins
+    memset(gHist, 0, sizeof(gHist));
+    int best = -1;
+    for (int y = ACCENT_STEP / 2; y < ARTWORK_HEIGHT; y += ACCENT_STEP) {
+        for (int x = ACCENT_STEP / 2; x < ARTWORK_WIDTH; x += ACCENT_STEP) {
+            int bin = accent_bin(gLut[px[y * ARTWORK_WIDTH + x]], r, g, b, chroma);
+            if (bin < 0) continue;
+            gHist[bin] += chroma >> 3;
+            if (best < 0 || gHist[bin] > gHist[best]) best = bin;
+        }
+    }
+    if (best < 0) return fallback;
+
+    // Mean color of the winning bin (second pass over the same samples)
+    uint32_t sr = 0, sg = 0, sb = 0, n = 0;
+    for (int y = ACCENT_STEP / 2; y < ARTWORK_HEIGHT; y += ACCENT_STEP) {
+        for (int x = ACCENT_STEP / 2; x < ARTWORK_WIDTH; x += ACCENT_STEP) {
+            if (accent_bin(gLut[px[y * ARTWORK_WIDTH + x]], r, g, b, chroma) != best) continue;
+            sr += r;
+            sg += g;
+            sb += b;
+            n++;
+        }
+    }
+    r = sr / n;
+    g = sg / n;
+    b = sb / n;
+
+    // The cards are near black: lift dark accents, keeping the hue
+    int mx = r > g ? (r > b ? r : b) : (g > b ? g : b);
+    if (mx < ACCENT_LIFT) {
+        r = r * ACCENT_LIFT / mx;
+        g = g * ACCENT_LIFT / mx;
+        b = b * ACCENT_LIFT / mx;
+    }
+    return ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+}
+
+// One box blur pass over n samples spaced step apart: running sums with
+// clamped edges, scaled by mul / 2^16
+static void box_blur_line(uint16_t* px, int n, int step, uint32_t mul) {
+    uint16_t line[ART_FX_BACKDROP_W > ART_FX_BACKDROP_H ? ART_FX_BACKDROP_W : ART_FX_BACKDROP_H];
+    for (int i = 0; i < n; ++i) line[i] = px[i * step];
+
+    uint32_t sr = 0, sg = 0, sb = 0;
+    for (int k = -BACKDROP_BLUR_R; k <= BACKDROP_BLUR_R; ++k) {
+        uint16_t p = line[k < 0 ? 0 : (k >= n ? n - 1 : k)];
+        sr += p >> 11;
+        sg += (p >> 5) & 0x3F;
+        sb += p & 0x1F;
+    }
+    for (int i = 0; i < n; ++i) {
+        px[i * step] = (uint16_t)((((sr * mul) >> 16) << 11) | (((sg * mul) >> 16) << 5) | ((sb * mul) >> 16));
+        int out = i - BACKDROP_BLUR_R, in = i + BACKDROP_BLUR_R + 1;
+        uint16_t po = line[out < 0 ? 0 : out];
+        uint16_t pi = line[in >= n ? n - 1 : in];
+        sr += (pi >> 11) - (po >> 11);
+        sg += ((pi >> 5) & 0x3F) - ((po >> 5) & 0x3F);
+        sb += (pi & 0x1F) - (po & 0x1F);
+    }
+}
+
+void art_fx_backdrop(const uint8_t* image, uint16_t* out) {
+    load_palette(image);
+    const uint8_t* px = image + ARTWORK_PALETTE_SIZE;
+    uint16_t row[ARTWORK_WIDTH];
+
+    // Center band with the backdrop's aspect, averaged down to the backdrop grid
+    int bandH = ARTWORK_WIDTH * ART_FX_BACKDROP_H / ART_FX_BACKDROP_W;
+    int y0 = (ARTWORK_HEIGHT - bandH) / 2;
+    resample_begin(&gBackdropResampler, ARTWORK_WIDTH, bandH, out, ART_FX_BACKDROP_W, ART_FX_BACKDROP_H, ART_FX_BACKDROP_W);
+    for (int y = 0; y < bandH; ++y) {
+        const uint8_t* idx = px + (y0 + y) * ARTWORK_WIDTH;
+        for (int x = 0; x < ARTWORK_WIDTH; ++x) row[x] = gLut[idx[x]];
+        resample_row(&gBackdropResampler, row);
+    }
+
+    const uint32_t taps = 2 * BACKDROP_BLUR_R + 1;
+    const uint32_t mean = 65536 / taps;
+    for (int y = 0; y < ART_FX_BACKDROP_H; ++y) {
+        box_blur_line(out + y * ART_FX_BACKDROP_W, ART_FX_BACKDROP_W, 1, mean);
+    }
+    for (int x = 0; x < ART_FX_BACKDROP_W; ++x) {
+        box_blur_line(out + x, ART_FX_BACKDROP_H, ART_FX_BACKDROP_W, mean * BACKDROP_DIM / 256);
+    }
+}
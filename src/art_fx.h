@@ -0,0 +1,16 @@
+#pragma once
+#include <Arduino.h>
+
+// Accent color of an artwork image (I8, ARTWORK_I8_SIZE bytes), as
+// 0xRRGGBB: the most common saturated hue, lifted to a usable brightness.
+// Returns fallback for images with no real color (black, white, grays).
+uint32_t art_fx_accent(const uint8_t* image, uint32_t fallback);
+
+// Backdrop: the cover's center band at the now-playing page's 8:5 aspect,
+// averaged down, box-blurred and darkened; LVGL stretches it to the page
+#define ART_FX_BACKDROP_W 40
+#define ART_FX_BACKDROP_H 25
+
+// Render the backdrop of an artwork image (I8) into out (ART_FX_BACKDROP_W x
+// ART_FX_BACKDROP_H native RGB565)
+void art_fx_backdrop(const uint8_t* image, uint16_t* out);
@@ -0,0 +1,244 @@
+/**
+ * @file art_palette.cpp
+ * Palette quantizer for the I8 artwork buffer (ingest task only)
+ *
+ * Median cut over a 4-4-4 bit histogram: the box with the most pixels times
+ * its longest edge is split at the median of that edge until there are 255
+ * boxes (or nothing left to split); each box's weighted mean is one palette
+ * entry. Entry 0 stays black for the letterbox bars.
+ *
+ * Mapping uses Floyd-Steinberg error diffusion in 8-bit channels. The
+ * nearest entry is looked up per histogram cell, computed lazily into the
+ * histogram's own memory once the palette is built: a cover touches a few
+ * hundred cells, not 4096.
+ */
+
+#include "art_palette.h"
+#include "resample.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define PAL_BITS 4
+#define PAL_LEVELS (1 << PAL_BITS)
+#define PAL_CELLS (PAL_LEVELS * PAL_LEVELS * PAL_LEVELS)
+#define PAL_COLORS 256
+#define PAL_LUT_EMPTY 0xFFFF
+
+struct PalBox {
+    uint8_t lo[3], hi[3];   // Inclusive cell bounds per channel (r, g, b)
+    uint32_t count;
+};
+
+struct PalWork {
+    uint16_t hist[PAL_CELLS];      // Pixel counts (saturating); after build: cell -> index LUT
+    PalBox boxes[PAL_COLORS - 1];
+};
+
+static PalWork* gWork = nullptr;
+static uint8_t gPal[PAL_COLORS][3];                      // r, g, b
+static int16_t gErr[2][3][RESAMPLE_MAX_DST_W + 2];       // This row, next row (1 pixel margin each side)
+
+static inline int cell_of(int r, int g, int b) {
+    return (r << (2 * PAL_BITS)) | (g << PAL_BITS) | b;
+}
+
+static inline int level8(int c) {
+    return c * 255 / (PAL_LEVELS - 1);
+}
+
+bool art_palette_begin() {
+    gWork = (PalWork*)malloc(sizeof(PalWork));
+    if (!gWork) return false;
+    memset(gWork->hist, 0, sizeof(gWork->hist));
+    return true;
+}
+
+void art_palette_count(const uint16_t* rgb565, int n) {
+    uint16_t* hist = gWork->hist;
+    for (int i = 0; i < n; ++i) {
+        uint16_t p = rgb565[i];
+        int c = cell_of(p >> 12, (p >> 7) & 0x0F, (p >> 1) & 0x0F);
+        if (hist[c] != 0xFFFF) hist[c]++;
+    }
+}
+
+// Shrink a box to its occupied cells and total its pixels; false if empty
+static bool shrink_box(PalBox* box) {
+    uint8_t lo[3] = { PAL_LEVELS, PAL_LEVELS, PAL_LEVELS }, hi[3] = { 0, 0, 0 };
+    uint32_t count = 0;
+    for (int r = box->lo[0]; r <= box->hi[0]; ++r) {
+        for (int g = box->lo[1]; g <= box->hi[1]; ++g) {
+            for (int b = box->lo[2]; b <= box->hi[2]; ++b) {
+                uint16_t n = gWork->hist[cell_of(r, g, b)];
+                if (!n) continue;
+                count += n;
+                int v[3] = { r, g, b };
+                for (int k = 0; k < 3; ++k) {
+                    if (v[k] < lo[k]) lo[k] = v[k];
+                    if (v[k] > hi[k]) hi[k] = v[k];
+                }
+            }
+        }
+    }
+    if (!count) return false;
+    memcpy(box->lo, lo, 3);
+    memcpy(box->hi, hi, 3);
+    box->count = count;
+    return true;
+}
+
+// Split box at the median of its longest edge into box and *other
+static void split_box(PalBox* box, PalBox* other) {
+    int axis = 0;
+    for (int k = 1; k < 3; ++k) {
+        if (box->hi[k] - box->lo[k] > box->hi[axis] - box->lo[axis]) axis = k;
+    }
+
+    uint32_t slice[PAL_LEVELS] = { 0 };
+    for (int r = box->lo[0]; r <= box->hi[0]; ++r) {
+        for (int g = box->lo[1]; g <= box->hi[1]; ++g) {
+            for (int b = box->lo[2]; b <= box->hi[2]; ++b) {
+                int v[3] = { r, g, b };
+                slice[v[axis]] += gWork->hist[cell_of(r, g, b)];
+            }
+        }
+    }
+
+    // Last slice of the lower half; both halves keep at least one slice
+    int cut = box->lo[axis];
+    uint32_t sum = slice[cut];
+    while (cut + 1 < box->hi[axis] && sum * 2 < box->count) sum += slice[++cut];
+
+    *other = *box;
+    box->hi[axis] = cut;
+    other->lo[axis] = cut + 1;
+    shrink_box(box);
+    shrink_box(other);
+}
+
+void art_palette_build(uint8_t* palette) {
+    PalBox* boxes = gWork->boxes;
+    int nBoxes = 0;
+    boxes[0] = { { 0, 0, 0 }, { PAL_LEVELS - 1, PAL_LEVELS - 1, PAL_LEVELS - 1 }, 0 };
+    if (shrink_box(&boxes[0])) nBoxes = 1;
+
+    while (nBoxes > 0 && nBoxes < PAL_COLORS - 1) {
+        int best = -1;
+        uint32_t bestScore = 0;
+        for (int i = 0; i < nBoxes; ++i) {
+            int edge = 0;
+            for (int k = 0; k < 3; ++k) {
+                if (boxes[i].hi[k] - boxes[i].lo[k] > edge) edge = boxes[i].hi[k] - boxes[i].lo[k];
+            }
+            uint32_t score = boxes[i].count * (uint32_t)edge;
+            if (score > bestScore) {
+                bestScore = score;
+                best = i;
+            }
+        }
+        if (best < 0) break;  // Every box is a single cell
+        split_box(&boxes[best], &boxes[nBoxes++]);
+    }
+
+    // Entry 0 black, then the weighted mean of each box, unused entries black
+    memset(gPal, 0, sizeof(gPal));
+    for (int i = 0; i < nBoxes; ++i) {
+        const PalBox& box = boxes[i];
+        uint32_t s[3] = { 0, 0, 0 };
+        for (int r = box.lo[0]; r <= box.hi[0]; ++r) {
+            for (int g = box.lo[1]; g <= box.hi[1]; ++g) {
+                for (int b = box.lo[2]; b <= box.hi[2]; ++b) {
+                    uint32_t n = gWork->hist[cell_of(r, g, b)];
+                    s[0] += n * level8(r);
+                    s[1] += n * level8(g);
+                    s[2] += n * level8(b);
+                }
+            }
+        }
+        for (int k = 0; k < 3; ++k) gPal[i + 1][k] = (uint8_t)((s[k] + box.count / 2) / box.count);
+    }
+
+    // LVGL palette entries are lv_color32_t: blue, green, red, alpha
+    for (int i = 0; i < PAL_COLORS; ++i) {
+        palette[i * 4 + 0] = gPal[i][2];
+        palette[i * 4 + 1] = gPal[i][1];
+        palette[i * 4 + 2] = gPal[i][0];
+        palette[i * 4 + 3] = 0xFF;
+    }
+
+    // The histogram becomes the lazily filled cell -> index LUT
+    for (int c = 0; c < PAL_CELLS; ++c) gWork->hist[c] = PAL_LUT_EMPTY;
+    memset(gErr, 0, sizeof(gErr));
+}
+
+// Palette index for an 8-bit color: nearest entry to its cell's center
+static uint8_t nearest(int r, int g, int b) {
+    int c = cell_of(r >> (8 - PAL_BITS), g >> (8 - PAL_BITS), b >> (8 - PAL_BITS));
+    uint16_t& slot = gWork->hist[c];
+    if (slot != PAL_LUT_EMPTY) return (uint8_t)slot;
+
+    int cr = level8(r >> (8 - PAL_BITS)), cg = level8(g >> (8 - PAL_BITS)), cb = level8(b >> (8 - PAL_BITS));
+    int best = 0;
+    int32_t bestD = INT32_MAX;
+    for (int i = 0; i < PAL_COLORS; ++i) {
+        int dr = cr - gPal[i][0], dg = cg - gPal[i][1], db = cb - gPal[i][2];
+        int32_t d = 2 * dr * dr + 4 * dg * dg + db * db;  // Rough luma weighting
+        if (d < bestD) {
+            bestD = d;
+            best = i;
+        }
+    }
+    slot = best;
+    return (uint8_t)best;
+}
+
+static inline int clamp8(int v) {
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+void art_palette_map_row(const uint16_t* rgb565, uint8_t* idx, int n) {
+    int16_t (*cur)[RESAMPLE_MAX_DST_W + 2] = gErr[0];
+    int16_t (*next)[RESAMPLE_MAX_DST_W + 2] = gErr[1];
+
+    for (int x = 0; x < n; ++x) {
+        uint16_t p = rgb565[x];
+        int want[3] = {
+            ((p >> 11) << 3) | (p >> 13),
+            (((p >> 5) & 0x3F) << 2) | ((p >> 9) & 0x03),
+            ((p & 0x1F) << 3) | ((p >> 2) & 0x07),
+        };
+        // Diffused error is kept in 1/16 units
+        for (int k = 0; k < 3; ++k) want[k] = clamp8(want[k] + cur[k][x + 1] / 16);
+
+        uint8_t i = nearest(want[0], want[1], want[2]);
+        idx[x] = i;
+        for (int k = 0; k < 3; ++k) {
+            int e = want[k] - gPal[i][k];
+            cur[k][x + 2] += e * 7;
+            next[k][x] += e * 3;
+            next[k][x + 1] += e * 5;
+            next[k][x + 2] += e;
+        }
+    }
+
+    // Next row's error becomes current; the one after starts clean
+    memcpy(gErr[0], gErr[1], sizeof(gErr[0]));
+    memset(gErr[1], 0, sizeof(gErr[1]));
+}
+
+void art_palette_end() {
+    free(gWork);
+    gWork = nullptr;
+}
+
+void art_palette_from_rgb565(const uint8_t* in, uint8_t* out) {
+    // Entry i is read before out[4i..4i+3] is written, and when in == out + 512
+    // those bytes only hold entries <= i: the expansion is safe in place
+    for (int i = 0; i < PAL_COLORS; ++i) {
+        uint16_t p = (uint16_t)(in[i * 2] | (in[i * 2 + 1] << 8));
+        out[i * 4 + 0] = ((p & 0x1F) << 3) | ((p >> 2) & 0x07);
+        out[i * 4 + 1] = (((p >> 5) & 0x3F) << 2) | ((p >> 9) & 0x03);
+        out[i * 4 + 2] = ((p >> 11) << 3) | (p >> 13);
+        out[i * 4 + 3] = 0xFF;
+    }
+}
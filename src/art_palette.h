@@ -0,0 +1,25 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Per-image 256-color palette for the I8 artwork buffer. Ingest task only.
+// Index 0 is always black (letterbox bars).
+//
+// Usage: art_palette_begin(), art_palette_count() over every source pixel,
+// art_palette_build(), then art_palette_map_row() once per output row in
+// order, and art_palette_end().
+
+// Start a histogram (heap, ~8 KB). False if out of memory.
+bool art_palette_begin();
+// Add n native RGB565 pixels to the histogram
+void art_palette_count(const uint16_t* rgb565, int n);
+// Pick the palette and write it as 256 LVGL ARGB8888 entries (1024 bytes)
+void art_palette_build(uint8_t* palette);
+// Map one row of n <= 80 pixels to palette indices, with error diffusion
+void art_palette_map_row(const uint16_t* rgb565, uint8_t* idx, int n);
+// Release the histogram
+void art_palette_end();
+
+// Expand a 256-entry RGB565 palette into the LVGL ARGB8888 layout. in may
+// point 512 bytes into out (the wire layout): entries are expanded in order.
+void art_palette_from_rgb565(const uint8_t* in, uint8_t* out);
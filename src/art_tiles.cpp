@@ -0,0 +1,156 @@
+/**
+ * @file art_tiles.cpp
+ * Tile-streamed ambient artwork
+ *
+ * A 240x240 image is 112 KB of RGB565, far more than we can spare, so the
+ * ambient view never holds a frame. The server streams tiles; the ingest
+ * task decodes each one into one of ART_TILE_BUFFERS small buffers and
+ * queues it, and the loop task blits it straight to the panel and hands the
+ * buffer back. The image builds up progressively as tiles arrive, and a
+ * slow UI simply makes the ingest task wait for a free buffer.
+ *
+ * The ambient screen is a plain black LVGL screen with nothing on top, so
+ * LVGL has no reason to redraw over the tiles while it is shown.
+ */
+
+#include "art_tiles.h"
+#include "base64_fast.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <TJpg_Decoder.h>
+#include <atomic>
+
+#define ART_TILE_CLEAR 0xFF         // Queue marker: clear the whole area
+#define ART_TILE_JPEG_MAX_SIZE 4096
+
+struct TileMsg {
+    uint8_t buf;                    // Index into gTileBuf, or ART_TILE_CLEAR
+    uint16_t x, y, w, h;            // Relative to the image
+};
+
+static uint16_t gTileBuf[ART_TILE_BUFFERS][ART_TILE_SIZE * ART_TILE_SIZE];
+static QueueHandle_t gFreeTiles = nullptr;
+static QueueHandle_t gReadyTiles = nullptr;
+
+static std::atomic<bool> gActive{false};
+static std::atomic<uint16_t> gAreaW{0}, gAreaH{0};
+static std::atomic<uint16_t> gImgW{0}, gImgH{0};
+
+void art_tiles_init() {
+    gFreeTiles = xQueueCreate(ART_TILE_BUFFERS, sizeof(uint8_t));
+    gReadyTiles = xQueueCreate(ART_TILE_BUFFERS + 2, sizeof(TileMsg));
+    if (!gFreeTiles || !gReadyTiles) {
+        Serial.println("[TILES] Failed to create queues!");
+        return;
+    }
+    for (uint8_t i = 0; i < ART_TILE_BUFFERS; ++i) xQueueSend(gFreeTiles, &i, 0);
+}
+
+void art_tiles_set_active(bool active, int areaW, int areaH) {
+    gAreaW = areaW;
+    gAreaH = areaH;
+    gActive = active;
+}
+
+bool art_tiles_is_active() {
+    return gActive;
+}
+
+void art_tiles_service(art_tiles_blit_fn blit, int maxTiles) {
+    if (!gReadyTiles) return;
+    TileMsg t;
+    for (int n = 0; n < maxTiles && xQueueReceive(gReadyTiles, &t, 0) == pdTRUE; ++n) {
+        if (gActive) {
+            if (t.buf == ART_TILE_CLEAR) {
+                blit(0, 0, gAreaW, gAreaH, nullptr);
+            } else {
+                blit((gAreaW - gImgW) / 2 + t.x, (gAreaH - gImgH) / 2 + t.y, t.w, t.h, gTileBuf[t.buf]);
+            }
+        }
+        if (t.buf != ART_TILE_CLEAR) xQueueSend(gFreeTiles, &t.buf, 0);
+    }
+}
+
+bool art_tiles_begin(int w, int h) {
+    if (!gActive || !gReadyTiles) return false;
+    if (w <= 0 || h <= 0 || w > ART_TILES_MAX_DIM || h > ART_TILES_MAX_DIM) {
+        Serial.printf("[TILES] Bad image size %dx%d\n", w, h);
+        return false;
+    }
+
+    // Queued tiles of the previous image still draw, then get cleared
+    TileMsg t = { ART_TILE_CLEAR, 0, 0, 0, 0 };
+    if (xQueueSend(gReadyTiles, &t, pdMS_TO_TICKS(500)) != pdTRUE) return false;
+    gImgW = w;
+    gImgH = h;
+    Serial.printf("[TILES] New image %dx%d\n", w, h);
+    return true;
+}
+
+// TJpgDec output for a tile: copy the block into the tile buffer, clipped
+static uint16_t* gJpegTile = nullptr;
+static int gJpegTileW = 0, gJpegTileH = 0;
+
+static bool tile_jpeg_cb(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t* bitmap) {
+    int cw = (x + w > gJpegTileW) ? gJpegTileW - x : w;
+    if (cw <= 0) return true;
+    for (int row = 0; row < h && y + row < gJpegTileH; ++row) {
+        memcpy(&gJpegTile[(y + row) * gJpegTileW + x], &bitmap[row * w], cw * 2);
+    }
+    return true;
+}
+
+static bool decode_tile_jpeg(uint16_t* dst, int w, int h, const char* b64, size_t b64Len) {
+    size_t jpgLen = b64_decoded_len(b64, b64Len);
+    if (jpgLen == 0 || jpgLen > ART_TILE_JPEG_MAX_SIZE) return false;
+    uint8_t* jpg = (uint8_t*)malloc(jpgLen);
+    if (!jpg) return false;
+
+    bool ok = false;
+    uint16_t jw = 0, jh = 0;
+    if (b64_decode_fast(b64, b64Len, jpg, jpgLen, &jpgLen) &&
+        TJpgDec.getJpgSize(&jw, &jh, jpg, jpgLen) == JDR_OK && jw == w && jh == h) {
+        gJpegTile = dst;
+        gJpegTileW = w;
+        gJpegTileH = h;
+        TJpgDec.setJpgScale(1);
+        TJpgDec.setSwapBytes(false);
+        TJpgDec.setCallback(tile_jpeg_cb);
+        ok = TJpgDec.drawJpg(0, 0, jpg, jpgLen) == JDR_OK;
+    }
+    free(jpg);
+    return ok;
+}
+
+bool art_tiles_put(int x, int y, int w, int h, const char* b64, size_t b64Len, bool jpeg) {
+    if (!gActive || !gFreeTiles) return false;
+    if (w <= 0 || h <= 0 || w > ART_TILE_SIZE || h > ART_TILE_SIZE ||
+        x < 0 || y < 0 || x + w > gImgW || y + h > gImgH) {
+        Serial.printf("[TILES] Tile %d,%d %dx%d outside %dx%d image\n", x, y, w, h, (int)gImgW, (int)gImgH);
+        return false;
+    }
+
+    // Wait for the UI to draw a tile if all buffers are in flight (backpressure on the stream)
+    uint8_t idx;
+    if (xQueueReceive(gFreeTiles, &idx, pdMS_TO_TICKS(500)) != pdTRUE) {
+        Serial.println("[TILES] No free tile buffer, dropping tile");
+        return false;
+    }
+
+    bool ok;
+    if (jpeg) {
+        ok = decode_tile_jpeg(gTileBuf[idx], w, h, b64, b64Len);
+    } else {
+        size_t outLen = 0;
+        ok = b64_decoded_len(b64, b64Len) == (size_t)(w * h * 2) &&
+             b64_decode_fast(b64, b64Len, (uint8_t*)gTileBuf[idx], sizeof(gTileBuf[idx]), &outLen);
+    }
+
+    TileMsg t = { idx, (uint16_t)x, (uint16_t)y, (uint16_t)w, (uint16_t)h };
+    if (!ok || xQueueSend(gReadyTiles, &t, pdMS_TO_TICKS(500)) != pdTRUE) {
+        Serial.printf("[TILES] Tile %d,%d failed\n", x, y);
+        xQueueSend(gFreeTiles, &idx, 0);
+        return false;
+    }
+    return true;
+}
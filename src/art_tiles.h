@@ -0,0 +1,27 @@
+#pragma once
+#include <Arduino.h>
+
+// Ambient (large) artwork, streamed as tiles and drawn straight to the panel
+#define ART_TILES_MAX_DIM 240   // Largest image edge (the panel height)
+#define ART_TILE_SIZE 40        // Largest tile edge; 40x40 RGB565 = 3200 bytes
+#define ART_TILE_BUFFERS 3      // Decoded tiles in flight between ingest and UI
+
+// Draw w*h native RGB565 pixels at (x, y) on the panel; px == nullptr = fill black
+typedef void (*art_tiles_blit_fn)(int x, int y, int w, int h, const uint16_t* px);
+
+// Create the tile queues (call once before the ingest task starts)
+void art_tiles_init();
+
+// --- UI side ---
+// Show/hide the ambient view; tiles are centered in an areaW x areaH panel
+void art_tiles_set_active(bool active, int areaW, int areaH);
+bool art_tiles_is_active();
+// Draw up to maxTiles decoded tiles and recycle their buffers (call from loop)
+void art_tiles_service(art_tiles_blit_fn blit, int maxTiles);
+
+// --- Ingest side ---
+// Start a new w x h image (clears the view). False if the view is closed.
+bool art_tiles_begin(int w, int h);
+// Decode one base64 tile (raw RGB565, or baseline JPEG if jpeg) at (x, y).
+// Blocks briefly while all tile buffers are waiting to be drawn.
+bool art_tiles_put(int x, int y, int w, int h, const char* b64, size_t b64Len, bool jpeg);
@@ -0,0 +1,600 @@
+/**
+ * @file artwork.cpp
+ * Album artwork ingest: base64 payload -> I8 back buffer -> UI
+ *
+ * The buffers hold LVGL I8 images: a 256-entry palette then one index per
+ * pixel, 7424 bytes instead of 12800 for RGB565. I8 payloads are already
+ * in that form (the RGB565 palette is expanded in place). Raw RGB565, JPEG
+ * and PNG are decoded twice: the first pass only feeds the palette
+ * histogram (art_palette.cpp), the second goes through the streaming
+ * area-averaging resampler (resample.cpp) whose rows are quantized straight
+ * into the index plane. Raw rows come through a one-row staging buffer,
+ * PNG rows straight from png_stream, and JPEG MCU blocks from TJpgDec are
+ * gathered into one MCU-high strip. No full-size source image is ever held.
+ * Decoded images that come with a key are also kept in the flash cache
+ * (artwork_cache.cpp) so a repeat only costs a file read.
+ *
+ * Images are identified by a CRC-32: of the payload bytes for raw and I8
+ * payloads (so a server can compute it), of the stored buffer otherwise.
+ *
+ * Two buffers: LVGL only ever reads the front one, the ingest task only
+ * writes the back one. A finished image is published by marking the back
+ * buffer READY; the UI swaps it to the front in artwork_take_new(). The
+ * swap and the ingest task's claim on the back buffer go through one atomic
+ * state, so a redraw can never see a half-written image.
+ *
+ * A third, standby buffer holds the next track's cover: the device asks for
+ * the artwork of queue[0] while the current track plays, a line tagged
+ * "prefetch_id" is decoded into standby instead of the back buffer, and on
+ * the track change the standby image is copied to the back buffer and
+ * published like any other (a 7 KB copy instead of a transfer and decode).
+ * The standby buffer belongs to the ingest task alone.
+ */
+
+#include "artwork.h"
+#include "art_palette.h"
+#include "artwork_cache.h"
+#include "base64_fast.h"
+#include "png_stream.h"
+#include "resample.h"
+#include <TJpg_Decoder.h>
+#include <esp_rom_crc.h>
+#include <atomic>
+
+// Largest compressed JPEG/PNG accepted (held on the heap only while decoding):
+// what the longest accepted payload decodes to
+#define ARTWORK_COMPRESSED_MAX_SIZE (ARTWORK_B64_MAX_LEN / 4 * 3)
+#define ARTWORK_B64_CHUNK 256       // Raw payloads are decoded this many chars at a time
+#define ARTWORK_JPEG_STRIP_ROWS 16  // Tallest MCU
+#define ARTWORK_JPEG_HIST_MIN 32    // Histogram pass: smallest reduced edge TJpgDec may produce
+#define ARTWORK_PREFETCH_RETRY_MS 30000  // Re-ask for the same next track if nothing came
+
+// I8 payloads are decoded to the end of the buffer so the palette can expand in place
+static_assert(ARTWORK_I8_SIZE - ARTWORK_I8_WIRE_SIZE == 512, "palette expansion needs a 512 byte gap");
+
+// Back buffer handshake between the ingest task and the UI
+enum BackState : uint8_t {
+    BACK_FREE,       // Ingest may claim it
+    BACK_WRITING,    // Ingest is decoding into it
+    BACK_READY,      // Holds a published image the UI has not taken yet
+    BACK_CONSUMING   // UI is swapping it to the front
+};
+
+// Front/back artwork buffers (decoded I8) - NOT in the queue
+static uint8_t gArtwork[2][ARTWORK_I8_SIZE] __attribute__((aligned(4)));
+static uint32_t gArtworkCrc[2] = { 0, 0 };      // CRC-32 identifying each buffer's image, 0 = unknown
+static char gArtworkKey[2][ARTWORK_KEY_LEN];    // Cache key of each buffer's image, if known
+static std::atomic<uint8_t> gFront{0};          // Written by the UI only
+static std::atomic<uint8_t> gBackState{BACK_FREE};
+
+// Ingest-task state
+static uint8_t gBackIdx = 1;   // Buffer being written (valid while BACK_WRITING)
+static uint8_t* gBack = nullptr;
+static uint8_t gLatest = 0;    // Newest complete image: front, or a READY back
+static uint32_t gArtworkGen = 0;  // Images published so far
+
+// Resampling state (ingest task only)
+static Resampler gResampler;
+static uint16_t gRow[RESAMPLE_MAX_SRC_DIM];    // Raw row staging
+static uint16_t gOutRow[RESAMPLE_MAX_DST_W];   // Resampled row, before quantizing
+static uint8_t* gOutIdx = nullptr;             // Index plane position of the image's top-left pixel
+static uint16_t* gStrip = nullptr;             // JPEG: one MCU row of output blocks
+static int gCountW = 0, gCountH = 0;           // JPEG histogram pass: reduced image size
+
+// Next-track prefetch (ingest task only)
+static uint8_t gStandby[ARTWORK_I8_SIZE] __attribute__((aligned(4)));
+static bool gStandbyReady = false;
+static uint32_t gStandbyCrc = 0;
+static char gStandbyId[ARTWORK_PREFETCH_ID_LEN];   // Queue item the standby image belongs to
+static char gStandbyKey[ARTWORK_KEY_LEN];          // Cache key it was prefetched under, if any
+static char gPrefetchId[ARTWORK_PREFETCH_ID_LEN];  // Set while a prefetch line decodes
+static char gAskedId[ARTWORK_PREFETCH_ID_LEN];     // Last item asked for
+static uint32_t gAskedMs = 0;
+static char gTrackUri[ARTWORK_PREFETCH_ID_LEN];    // Playing track as of the last snapshot
+
+// Claim the back buffer, taking back a published image the UI has not shown yet.
+// That image is gone once anything is written, so callers validate or decode
+// everything that can fail first and only write what is known good.
+// While a prefetch line decodes, the standby buffer is the target instead.
+static uint8_t* begin_write() {
+    if (gPrefetchId[0]) {
+        gStandbyReady = false;
+        gBack = gStandby;
+        return gBack;
+    }
+    uint8_t s = gBackState.load();
+    for (;;) {
+        if (s == BACK_CONSUMING) {
+            s = gBackState.load();  // UI is mid-swap, a few instructions
+            continue;
+        }
+        if (gBackState.compare_exchange_weak(s, BACK_WRITING)) break;
+    }
+    gBackIdx = 1 - gFront.load();
+    gLatest = 1 - gBackIdx;
+    gArtworkCrc[gBackIdx] = 0;
+    gArtworkKey[gBackIdx][0] = '\0';
+    gBack = gArtwork[gBackIdx];
+    return gBack;
+}
+
+// Give up on the back buffer (decode failed or nothing new); the front is untouched
+static void abort_write() {
+    if (gPrefetchId[0]) return;  // Standby stays invalid
+    gBackState.store(BACK_FREE);
+}
+
+// Publish the back buffer: new image unless it matches the latest one. crc
+// identifies the image; 0 = use the CRC of the buffer itself.
+static bool commit_decoded(uint32_t crc = 0) {
+    if (crc == 0) crc = esp_rom_crc32_le(0, gBack, ARTWORK_I8_SIZE);
+    if (gPrefetchId[0]) {
+        gStandbyCrc = crc;
+        strcpy(gStandbyId, gPrefetchId);
+        gStandbyKey[0] = '\0';
+        gStandbyReady = true;
+        return true;
+    }
+    if (crc == gArtworkCrc[gLatest]) {
+        Serial.printf("[ARTWORK] Same content (crc %08x), skipping\n", crc);
+        abort_write();
+        return false;
+    }
+    gArtworkCrc[gBackIdx] = crc;
+    gLatest = gBackIdx;
+    gArtworkGen++;
+    gBackState.store(BACK_READY);
+    return true;
+}
+
+uint32_t artwork_generation() {
+    return gArtworkGen;
+}
+
+// "1a2b3c4d" -> 0x1a2b3c4d; false unless the key is exactly 8 hex digits
+static bool parse_crc_key(const char* key, uint32_t* crc) {
+    uint32_t v = 0;
+    int n = 0;
+    for (; key[n]; ++n) {
+        char c = key[n];
+        int d = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+        if (d < 0 || n >= 8) return false;
+        v = (v << 4) | d;
+    }
+    *crc = v;
+    return n == 8;
+}
+
+// UI side: swap a published image to the front
+const uint8_t* artwork_take_new() {
+    uint8_t expected = BACK_READY;
+    if (!gBackState.compare_exchange_strong(expected, BACK_CONSUMING)) return nullptr;
+    uint8_t front = 1 - gFront.load();
+    gFront.store(front);
+    gBackState.store(BACK_FREE);
+    return gArtwork[front];
+}
+
+// Resampler row sink: quantize into the back buffer's index plane
+static void emit_indexed_row(int y, const uint16_t* row, void* user) {
+    (void)user;
+    art_palette_map_row(row, gOutIdx + y * ARTWORK_WIDTH, gResampler.dstW);
+}
+
+// Second pass setup, before the back buffer is claimed: fit a srcW x srcH
+// image into the artwork through gResampler. False if it rejects the size.
+static bool prepare_indexed(int srcW, int srcH) {
+    int outW, outH;
+    resample_fit(srcW, srcH, ARTWORK_WIDTH, ARTWORK_HEIGHT, &outW, &outH);
+    if (!resample_begin(&gResampler, srcW, srcH, gOutRow, outW, outH, outW)) {
+        Serial.printf("[ARTWORK] Resampler rejected %dx%d\n", srcW, srcH);
+        return false;
+    }
+    resample_on_row(&gResampler, emit_indexed_row, nullptr);
+    return true;
+}
+
+// Once claimed: write the palette and letterbox the index plane with index 0 (black)
+static void begin_indexed() {
+    art_palette_build(gBack);
+    int outW = gResampler.dstW, outH = gResampler.dstH;
+    uint8_t* idx = gBack + ARTWORK_PALETTE_SIZE;
+    if (outW < ARTWORK_WIDTH || outH < ARTWORK_HEIGHT) {
+        memset(idx, 0, ARTWORK_WIDTH * ARTWORK_HEIGHT);  // Letterbox
+    }
+    gOutIdx = idx + ((ARTWORK_HEIGHT - outH) / 2) * ARTWORK_WIDTH + (ARTWORK_WIDTH - outW) / 2;
+}
+
+static bool palette_begin() {
+    if (art_palette_begin()) return true;
+    Serial.println("[ARTWORK] No memory for the palette histogram");
+    return false;
+}
+
+// Legacy payload: square RGB565, size implied by the length (80x80 normally)
+bool artwork_decode_b64(const char* b64, size_t b64Len) {
+    return artwork_decode_rgb565_b64(b64, b64Len, 0, 0);
+}
+
+static void raw_row_count(const uint16_t* row, int w) {
+    art_palette_count(row, w);
+}
+
+static void raw_row_resample(const uint16_t* row, int w) {
+    (void)w;
+    resample_row(&gResampler, row);
+}
+
+// Stream a raw RGB565 payload through fn one row at a time, chaining the
+// payload CRC into *crc if given. Quads never straddle chunks, and only the
+// last chunk may carry padding (a '=' mid-payload would leave rows short).
+static bool for_each_raw_row(const char* b64, size_t b64Len, int w, void (*fn)(const uint16_t* row, int w), uint32_t* crc) {
+    uint8_t chunk[ARTWORK_B64_CHUNK / 4 * 3];
+    uint8_t* row = (uint8_t*)gRow;
+    size_t rowBytes = (size_t)w * 2, have = 0;
+    for (size_t pos = 0; pos < b64Len; pos += ARTWORK_B64_CHUNK) {
+        size_t n = b64Len - pos < ARTWORK_B64_CHUNK ? b64Len - pos : ARTWORK_B64_CHUNK;
+        size_t got = 0;
+        if (!b64_decode_fast(b64 + pos, n, chunk, sizeof(chunk), &got)) return false;
+        if (pos + n < b64Len && got != n / 4 * 3) return false;
+        if (crc) *crc = esp_rom_crc32_le(*crc, chunk, got);
+        for (size_t k = 0; k < got;) {
+            size_t take = rowBytes - have < got - k ? rowBytes - have : got - k;
+            memcpy(row + have, chunk + k, take);
+            have += take;
+            k += take;
+            if (have == rowBytes) {
+                fn(gRow, w);
+                have = 0;
+            }
+        }
+    }
+    return true;
+}
+
+// Decode base64 RGB565 artwork of any size into the back buffer
+bool artwork_decode_rgb565_b64(const char* b64, size_t b64Len, int w, int h) {
+    Serial.printf("[ARTWORK] Decoding %d chars...\n", b64Len);
+
+    size_t rawLen = b64_decoded_len(b64, b64Len);
+    if (w <= 0 || h <= 0) {
+        w = 1;
+        while ((size_t)(w + 1) * (w + 1) * 2 <= rawLen) w++;
+        h = w;
+    }
+    // Reject wrong-sized payloads before touching the buffer
+    if (rawLen != (size_t)w * h * 2 || w > RESAMPLE_MAX_SRC_DIM || h > RESAMPLE_MAX_SRC_DIM) {
+        Serial.printf("[ARTWORK] Decode failed: size=%d for %dx%d\n", rawLen, w, h);
+        return false;
+    }
+    if (!palette_begin()) return false;
+
+    uint32_t t0 = micros();
+    uint32_t crc = 0;
+    bool ok = for_each_raw_row(b64, b64Len, w, raw_row_count, &crc) && prepare_indexed(w, h);
+    if (ok) {
+        begin_write();
+        begin_indexed();
+        ok = for_each_raw_row(b64, b64Len, w, raw_row_resample, nullptr) &&
+             gResampler.dstY == gResampler.dstH;
+        if (!ok) abort_write();
+    }
+    art_palette_end();
+    uint32_t decodeUs = micros() - t0;
+
+    if (!ok) {
+        Serial.println("[ARTWORK] Decode failed: invalid base64");
+        return false;
+    }
+    if (!commit_decoded(crc)) return false;
+    Serial.printf("[ARTWORK] Decode success! %dx%d in %u us (crc %08x), published\n",
+                  w, h, decodeUs, gArtworkCrc[gLatest]);
+    return true;
+}
+
+// Check a whole base64 payload a chunk at a time without storing it,
+// chaining the payload CRC into *crc. Padding may only end the payload.
+static bool b64_check(const char* b64, size_t b64Len, uint32_t* crc) {
+    uint8_t chunk[ARTWORK_B64_CHUNK / 4 * 3];
+    for (size_t pos = 0; pos < b64Len; pos += ARTWORK_B64_CHUNK) {
+        size_t n = b64Len - pos < ARTWORK_B64_CHUNK ? b64Len - pos : ARTWORK_B64_CHUNK;
+        size_t got = 0;
+        if (!b64_decode_fast(b64 + pos, n, chunk, sizeof(chunk), &got)) return false;
+        if (pos + n < b64Len && got != n / 4 * 3) return false;
+        *crc = esp_rom_crc32_le(*crc, chunk, got);
+    }
+    return true;
+}
+
+// Decode base64 I8 artwork (RGB565 palette + indices) into the back buffer
+bool artwork_decode_i8_b64(const char* b64, size_t b64Len) {
+    size_t rawLen = b64_decoded_len(b64, b64Len);
+    if (rawLen != ARTWORK_I8_WIRE_SIZE) {
+        Serial.printf("[ARTWORK] I8 decode failed: size=%d\n", rawLen);
+        return false;
+    }
+
+    // Validate before claiming the back buffer, so a bad payload cannot cost
+    // the published image the UI has not taken yet
+    uint32_t t0 = micros();
+    uint32_t crc = 0;
+    if (!b64_check(b64, b64Len, &crc)) {
+        Serial.println("[ARTWORK] I8 decode failed: invalid base64");
+        return false;
+    }
+    uint8_t* wire = begin_write() + (ARTWORK_I8_SIZE - ARTWORK_I8_WIRE_SIZE);
+    size_t outLen = 0;
+    b64_decode_fast(b64, b64Len, wire, ARTWORK_I8_WIRE_SIZE, &outLen);  // Known good
+    art_palette_from_rgb565(wire, gBack);  // Indices are already in place
+
+    if (!commit_decoded(crc)) return false;
+    Serial.printf("[ARTWORK] I8 decode success in %u us (crc %08x), published\n", micros() - t0, crc);
+    return true;
+}
+
+// TJpgDec output, histogram pass: count the block's pixels inside the image
+static bool jpeg_count_cb(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t* bitmap) {
+    if (x >= gCountW || y >= gCountH) return true;
+    int cw = (x + w > gCountW) ? gCountW - x : w;
+    int ch = (y + h > gCountH) ? gCountH - y : h;
+    for (int row = 0; row < ch; ++row) art_palette_count(&bitmap[row * w], cw);
+    return true;
+}
+
+// TJpgDec output: one MCU block, gathered into the strip; a full strip is resampled
+static bool jpeg_block_cb(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t* bitmap) {
+    (void)y;  // Blocks arrive in raster order
+    int srcW = gResampler.srcW;
+    if (x >= srcW) return true;
+    int cw = (x + w > srcW) ? srcW - x : w;
+    if (h > ARTWORK_JPEG_STRIP_ROWS) h = ARTWORK_JPEG_STRIP_ROWS;
+
+    for (int row = 0; row < h; ++row) {
+        memcpy(&gStrip[row * srcW + x], &bitmap[row * w], cw * 2);
+    }
+    if (x + w >= srcW) {
+        for (int row = 0; row < h; ++row) resample_row(&gResampler, &gStrip[row * srcW]);
+    }
+    return true;  // Keep decoding
+}
+
+// Decode base64 JPEG artwork into the back buffer: TJpgDec reduces by 1/2/4/8
+// while the image still covers the widget, the resampler does the rest. The
+// histogram pass runs at the largest reduction that keeps some detail.
+bool artwork_decode_jpeg_b64(const char* b64, size_t b64Len) {
+    size_t jpgLen = b64_decoded_len(b64, b64Len);
+    if (jpgLen == 0 || jpgLen > ARTWORK_COMPRESSED_MAX_SIZE) {
+        Serial.printf("[ARTWORK] JPEG size %d out of range\n", jpgLen);
+        return false;
+    }
+
+    uint8_t* jpg = (uint8_t*)malloc(jpgLen);
+    if (!jpg) {
+        Serial.printf("[ARTWORK] No memory for %d byte JPEG\n", jpgLen);
+        return false;
+    }
+
+    uint32_t t0 = micros();
+    bool ok = false;
+    uint16_t w = 0, hgt = 0;
+    if (!b64_decode_fast(b64, b64Len, jpg, jpgLen, &jpgLen)) {
+        Serial.println("[ARTWORK] JPEG decode failed: invalid base64");
+    } else if (TJpgDec.getJpgSize(&w, &hgt, jpg, jpgLen) != JDR_OK || w == 0 || hgt == 0) {
+        Serial.println("[ARTWORK] JPEG decode failed: bad header");
+    } else {
+        int fitW, fitH;
+        resample_fit(w, hgt, ARTWORK_WIDTH, ARTWORK_HEIGHT, &fitW, &fitH);
+        uint8_t scale = 1;
+        while (scale < 8 && w / (scale * 2) >= fitW && hgt / (scale * 2) >= fitH) scale <<= 1;
+        int outW = w / scale, outH = hgt / scale;
+        uint8_t histScale = scale;
+        while (histScale < 8 && w / (histScale * 2) >= ARTWORK_JPEG_HIST_MIN && hgt / (histScale * 2) >= ARTWORK_JPEG_HIST_MIN) histScale <<= 1;
+
+        gStrip = (outW <= RESAMPLE_MAX_SRC_DIM && outH <= RESAMPLE_MAX_SRC_DIM)
+                 ? (uint16_t*)malloc(outW * ARTWORK_JPEG_STRIP_ROWS * 2) : nullptr;
+        if (!gStrip) {
+            Serial.printf("[ARTWORK] JPEG %dx%d too large\n", w, hgt);
+        } else if (palette_begin()) {
+            TJpgDec.setSwapBytes(false);  // LVGL wants native-endian RGB565
+            gCountW = w / histScale;
+            gCountH = hgt / histScale;
+            TJpgDec.setJpgScale(histScale);
+            TJpgDec.setCallback(jpeg_count_cb);
+            JRESULT jr = TJpgDec.drawJpg(0, 0, jpg, jpgLen);
+            bool writing = (jr == JDR_OK && prepare_indexed(outW, outH));
+            if (writing) {
+                begin_write();
+                begin_indexed();
+                TJpgDec.setJpgScale(scale);
+                TJpgDec.setCallback(jpeg_block_cb);
+                jr = TJpgDec.drawJpg(0, 0, jpg, jpgLen);
+            }
+            ok = (writing && jr == JDR_OK && gResampler.dstY == gResampler.dstH);
+            if (!ok) {
+                Serial.printf("[ARTWORK] JPEG decode failed: jr=%d\n", jr);
+                if (writing) abort_write();
+            } else {
+                Serial.printf("[ARTWORK] JPEG %dx%d (1/%d) decoded from %d bytes in %u us\n",
+                              w, hgt, scale, jpgLen, micros() - t0);
+            }
+            art_palette_end();
+        }
+        free(gStrip);
+        gStrip = nullptr;
+    }
+    free(jpg);
+
+    if (!ok) return false;
+    return commit_decoded();
+}
+
+// png_stream output, histogram pass
+static void png_row_cb_count(int y, const uint16_t* rgb565, int width, void* user) {
+    (void)y;
+    (void)user;
+    art_palette_count(rgb565, width);
+}
+
+// png_stream output: one RGB565 row, straight into the resampler
+static void png_row_cb_artwork(int y, const uint16_t* rgb565, int width, void* user) {
+    (void)y;
+    (void)width;
+    (void)user;
+    resample_row(&gResampler, rgb565);
+}
+
+// Decode base64 PNG artwork into the back buffer, resampled to fit
+bool artwork_decode_png_b64(const char* b64, size_t b64Len) {
+    // Older servers put raw RGB565 in artwork_png_b64; PNGs always start "iVBORw0KGgo"
+    if (b64Len < 11 || memcmp(b64, "iVBORw0KGgo", 11) != 0) {
+        return artwork_decode_b64(b64, b64Len);
+    }
+
+    size_t pngLen = b64_decoded_len(b64, b64Len);
+    if (pngLen == 0 || pngLen > ARTWORK_COMPRESSED_MAX_SIZE) {
+        Serial.printf("[ARTWORK] PNG size %d out of range\n", pngLen);
+        return false;
+    }
+
+    uint8_t* png = (uint8_t*)malloc(pngLen);
+    if (!png) {
+        Serial.printf("[ARTWORK] No memory for %d byte PNG\n", pngLen);
+        return false;
+    }
+
+    uint32_t t0 = micros();
+    bool ok = false;
+    uint16_t w = 0, hgt = 0;
+    if (!b64_decode_fast(b64, b64Len, png, pngLen, &pngLen)) {
+        Serial.println("[ARTWORK] PNG decode failed: invalid base64");
+    } else if (!png_get_size(png, pngLen, &w, &hgt) || w > PNG_MAX_DIM || hgt > PNG_MAX_DIM) {
+        Serial.printf("[ARTWORK] PNG decode failed: bad header (%dx%d)\n", w, hgt);
+    } else if (palette_begin()) {
+        ok = png_decode_rows(png, pngLen, png_row_cb_count, nullptr) && prepare_indexed(w, hgt);
+        if (ok) {
+            begin_write();
+            begin_indexed();
+            ok = png_decode_rows(png, pngLen, png_row_cb_artwork, nullptr) &&
+                 gResampler.dstY == gResampler.dstH;
+            if (!ok) abort_write();
+        }
+        art_palette_end();
+        if (!ok) {
+            Serial.println("[ARTWORK] PNG decode failed: unsupported or corrupt");
+        } else {
+            Serial.printf("[ARTWORK] PNG %dx%d decoded from %d bytes in %u us\n",
+                          w, hgt, pngLen, micros() - t0);
+        }
+    }
+    free(png);
+
+    if (!ok) return false;
+    return commit_decoded();
+}
+
+// Show a cached image by key; true if it is (now) the latest image
+bool artwork_show_cached(const char* key) {
+    // Already showing it: same cache key, or the key is the CRC of the current image
+    const char* latestKey = gArtworkKey[gLatest];
+    if (latestKey[0] && strcmp(key, latestKey) == 0) return true;
+    uint32_t crc;
+    if (gArtworkCrc[gLatest] && parse_crc_key(key, &crc) && crc == gArtworkCrc[gLatest]) return true;
+
+    // Claim the back buffer only on a hit: begin_write takes back a published
+    // image the UI has not shown yet, and a miss must not lose it.
+    if (!artwork_cache_contains(key)) return false;
+    // Read into a scratch copy first: a failed read must not cost it either
+    uint8_t* img = (uint8_t*)malloc(ARTWORK_I8_SIZE);
+    if (!img) {
+        Serial.println("[ARTWORK] No memory to load a cached image");
+        return false;
+    }
+    if (!artwork_cache_load(key, img)) {
+        free(img);
+        return false;
+    }
+    memcpy(begin_write(), img, ARTWORK_I8_SIZE);
+    free(img);
+    strncpy(gArtworkKey[gBackIdx], key, ARTWORK_KEY_LEN - 1);
+    gArtworkKey[gBackIdx][ARTWORK_KEY_LEN - 1] = '\0';
+    // A CRC key names the image's identity CRC (payload CRC for raw and I8)
+    if (!commit_decoded(parse_crc_key(key, &crc) ? crc : 0)) {
+        // Cached copy of the latest image: just tag it
+        strncpy(gArtworkKey[gLatest], key, ARTWORK_KEY_LEN - 1);
+        gArtworkKey[gLatest][ARTWORK_KEY_LEN - 1] = '\0';
+    }
+    return true;
+}
+
+// Tag the image just decoded with its key and add it to the flash cache
+void artwork_remember(const char* key) {
+    // Prefetch payload: the key goes with the standby image until it is promoted
+    if (gPrefetchId[0]) {
+        if (!gStandbyReady || strcmp(gStandbyId, gPrefetchId) != 0) return;
+        uint32_t crc;
+        if (parse_crc_key(key, &crc) && crc != gStandbyCrc) return;
+        artwork_cache_store(key, gStandby);
+        strncpy(gStandbyKey, key, ARTWORK_KEY_LEN - 1);
+        gStandbyKey[ARTWORK_KEY_LEN - 1] = '\0';
+        return;
+    }
+
+    // A CRC key must describe this exact image; anything else is a corrupt payload or a bad key
+    uint32_t crc;
+    if (parse_crc_key(key, &crc) && crc != gArtworkCrc[gLatest]) {
+        Serial.printf("[ARTWORK] Key %s does not match pixels (crc %08x), not caching\n", key, gArtworkCrc[gLatest]);
+        return;
+    }
+    // Read-only access; the UI may already be showing this buffer
+    artwork_cache_store(key, gArtwork[gLatest]);
+    strncpy(gArtworkKey[gLatest], key, ARTWORK_KEY_LEN - 1);
+    gArtworkKey[gLatest][ARTWORK_KEY_LEN - 1] = '\0';
+}
+
+void artwork_prefetch_begin(const char* id) {
+    strncpy(gPrefetchId, id, ARTWORK_PREFETCH_ID_LEN - 1);
+    gPrefetchId[ARTWORK_PREFETCH_ID_LEN - 1] = '\0';
+}
+
+void artwork_prefetch_end() {
+    if (gStandbyReady && strcmp(gStandbyId, gPrefetchId) == 0) {
+        Serial.printf("[ARTWORK] Prefetched %s (crc %08x)\n", gStandbyId, gStandbyCrc);
+    }
+    gPrefetchId[0] = '\0';
+}
+
+bool artwork_note_track(const char* trackUri, const char* nextId) {
+    bool promoted = false;
+
+    // Track change: publish the standby image if it is this track's
+    if (trackUri[0] && strcmp(trackUri, gTrackUri) != 0) {
+        strncpy(gTrackUri, trackUri, ARTWORK_PREFETCH_ID_LEN - 1);
+        gTrackUri[ARTWORK_PREFETCH_ID_LEN - 1] = '\0';
+        if (gStandbyReady && strcmp(gStandbyId, gTrackUri) == 0) {
+            uint32_t t0 = micros();
+            memcpy(begin_write(), gStandby, ARTWORK_I8_SIZE);
+            promoted = commit_decoded(gStandbyCrc);
+            // Carry the prefetch key over so the track's artwork_key announce is a hit
+            if (gStandbyKey[0] && (promoted || !gArtworkKey[gLatest][0])) {
+                strcpy(gArtworkKey[gLatest], gStandbyKey);
+            }
+            gStandbyReady = false;
+            Serial.printf("[ARTWORK] Standby promoted for %s in %u us\n", gTrackUri, micros() - t0);
+        }
+    }
+
+    // Ask for the next track's cover unless it is already waiting
+    if (!nextId[0]) return promoted;
+    const char* next = nextId;
+    if (gStandbyReady && strcmp(gStandbyId, next) == 0) return promoted;
+    uint32_t now = millis();
+    if (strcmp(gAskedId, next) == 0 && now - gAskedMs < ARTWORK_PREFETCH_RETRY_MS) return promoted;
+
+    char cmd[128];
+    snprintf(cmd, sizeof(cmd), "{\"cmd\":\"artwork_prefetch\",\"id\":\"%s\"}", next);
+    send_reply(cmd);
+    strncpy(gAskedId, next, ARTWORK_PREFETCH_ID_LEN - 1);
+    gAskedId[ARTWORK_PREFETCH_ID_LEN - 1] = '\0';
+    gAskedMs = now;
+    return promoted;
+}
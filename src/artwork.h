@@ -0,0 +1,59 @@
+#pragma once
+#include <Arduino.h>
+#include "data_model.h"
+
+// Longest base64 payload a standalone artwork line may carry
+#define ARTWORK_B64_MAX_LEN 20000
+
+// Decode base64 RGB565 artwork into the global artwork buffer (LVGL I8,
+// ARTWORK_I8_SIZE bytes, quantized on the device). The payload is square,
+// its size implied by the length (normally 80x80).
+// Returns true if new artwork was stored (false if the decoded pixels are
+// identical to the current image, or the payload is invalid).
+bool artwork_decode_b64(const char* b64, size_t b64Len);
+
+// Same for a w x h RGB565 payload (up to RESAMPLE_MAX_SRC_DIM per edge).
+// Every size other than 80x80 is area-averaged to fit and letterboxed.
+bool artwork_decode_rgb565_b64(const char* b64, size_t b64Len, int w, int h);
+
+// Decode base64 I8 artwork: ARTWORK_I8_WIRE_SIZE bytes, 256 native RGB565
+// palette entries then 80x80 indices. Stored as is. Same return convention.
+bool artwork_decode_i8_b64(const char* b64, size_t b64Len);
+
+// Decode base64 JPEG artwork (baseline) into the same buffer, resampled to
+// fit and letterboxed. Same return convention.
+bool artwork_decode_jpeg_b64(const char* b64, size_t b64Len);
+
+// Decode base64 PNG artwork (non-interlaced, any color type) into the same
+// buffer, resampled to fit and letterboxed. Payloads without the PNG
+// signature fall back to raw RGB565. Same return convention.
+bool artwork_decode_png_b64(const char* b64, size_t b64Len);
+
+// Number of images published so far (ingest task only): DOMAIN_ARTWORK's content
+uint32_t artwork_generation();
+
+// Load the image cached under key (see artwork_cache.h) into the buffer.
+// An 8-hex-digit key also matches the CRC-32 of the image already shown
+// (of the payload bytes, for raw RGB565 and I8 payloads).
+// True if that image is now displayed, false on a cache miss.
+bool artwork_show_cached(const char* key);
+
+// After a successful decode: remember the buffer under key and cache it on flash.
+// 8-hex-digit keys must equal the image's CRC-32 or nothing is cached.
+// Between artwork_prefetch_begin/end it tags the standby image instead, and
+// the key is carried over when that image is promoted.
+void artwork_remember(const char* key);
+
+// Next-track prefetch: standby buffer for the cover of queue[0]
+#define ARTWORK_PREFETCH_ID_LEN 80   // Track URI / queue item ID + NUL
+
+// Decode the artwork lines between these two calls into the standby buffer,
+// as the image of queue item id, instead of showing them
+void artwork_prefetch_begin(const char* id);
+void artwork_prefetch_end();
+
+// Once per snapshot with the playing track and the first queue item's ID
+// ("" if none): on a track change to the standby image's item, publish it
+// (true if that produced a new image); asks the server for the next item's
+// artwork if standby does not hold it yet.
+bool artwork_note_track(const char* trackUri, const char* nextId);
@@ -0,0 +1,223 @@
+/**
+ * @file artwork_cache.cpp
+ * Persistent LRU cache of decoded artwork on LittleFS
+ *
+ * Each entry is one I8 image file (/art/<key>.i8, palette then indices) so a
+ * hit is a single 7.4 KB read straight into the artwork buffer. A small index file keeps a
+ * use counter per key for LRU order. To spare the flash, entry files are
+ * written once and never rewritten, and hits only touch the in-RAM index,
+ * which is saved when entries change or at most every ARTWORK_CACHE_FLUSH_MS.
+ */
+
+#include "artwork_cache.h"
+#include <LittleFS.h>
+
+#define ARTWORK_CACHE_DIR "/art"
+#define ARTWORK_CACHE_INDEX "/art/index.bin"
+#define ARTWORK_CACHE_MAGIC 0x32435241      // "ARC2" (I8 entries)
+#define ARTWORK_CACHE_MAX_ENTRIES 16
+#define ARTWORK_CACHE_ENTRY_COST 8192       // 7424 bytes rounded up to 4 KB flash blocks
+#define ARTWORK_CACHE_FLUSH_MS 60000
+
+struct CacheEntry {
+    char key[ARTWORK_KEY_LEN];  // Empty = free slot
+    uint32_t lastUse;
+};
+
+struct CacheIndex {
+    uint32_t magic;
+    uint32_t tick;              // Monotonic use counter
+    CacheEntry entries[ARTWORK_CACHE_MAX_ENTRIES];
+};
+
+static CacheIndex gIndex;
+static bool gCacheReady = false;
+static bool gIndexDirty = false;
+static uint32_t gLastFlushMs = 0;
+static uint8_t gMaxEntries = 0;     // Budget: 3/4 of the partition, capped by the index size
+
+static void entry_path(char* out, size_t outSize, const char* key) {
+    snprintf(out, outSize, ARTWORK_CACHE_DIR "/%s.i8", key);
+}
+
+static void flush_index() {
+    File f = LittleFS.open(ARTWORK_CACHE_INDEX, "w");
+    if (!f) return;
+    f.write((const uint8_t*)&gIndex, sizeof(gIndex));
+    f.close();
+    gIndexDirty = false;
+    gLastFlushMs = millis();
+}
+
+static void maybe_flush_index() {
+    if (gIndexDirty && millis() - gLastFlushMs > ARTWORK_CACHE_FLUSH_MS) flush_index();
+}
+
+static CacheEntry* find_entry(const char* key) {
+    for (CacheEntry& e : gIndex.entries) {
+        if (e.key[0] && strcmp(e.key, key) == 0) return &e;
+    }
+    return nullptr;
+}
+
+static int used_entries() {
+    int n = 0;
+    for (const CacheEntry& e : gIndex.entries) n += e.key[0] ? 1 : 0;
+    return n;
+}
+
+static void evict_lru() {
+    CacheEntry* victim = nullptr;
+    for (CacheEntry& e : gIndex.entries) {
+        if (e.key[0] && (!victim || e.lastUse < victim->lastUse)) victim = &e;
+    }
+    if (!victim) return;
+
+    char path[48];
+    entry_path(path, sizeof(path), victim->key);
+    LittleFS.remove(path);
+    Serial.printf("[ARTCACHE] Evicted %s\n", victim->key);
+    memset(victim, 0, sizeof(*victim));
+}
+
+bool artwork_cache_valid_key(const char* key) {
+    size_t n = 0;
+    for (; key[n]; ++n) {
+        char c = key[n];
+        bool ok = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == '-';
+        if (!ok || n + 1 >= ARTWORK_KEY_LEN) return false;
+    }
+    return n > 0;
+}
+
+bool artwork_cache_init() {
+    if (!LittleFS.begin(true)) {
+        Serial.println("[ARTCACHE] LittleFS mount failed, cache disabled");
+        return false;
+    }
+    LittleFS.mkdir(ARTWORK_CACHE_DIR);
+
+    size_t budget = LittleFS.totalBytes() / 4 * 3;
+    gMaxEntries = budget / ARTWORK_CACHE_ENTRY_COST;
+    if (gMaxEntries > ARTWORK_CACHE_MAX_ENTRIES) gMaxEntries = ARTWORK_CACHE_MAX_ENTRIES;
+
+    memset(&gIndex, 0, sizeof(gIndex));
+    File f = LittleFS.open(ARTWORK_CACHE_INDEX, "r");
+    if (f) {
+        if (f.read((uint8_t*)&gIndex, sizeof(gIndex)) != sizeof(gIndex) || gIndex.magic != ARTWORK_CACHE_MAGIC) {
+            memset(&gIndex, 0, sizeof(gIndex));
+        }
+        f.close();
+    }
+    gIndex.magic = ARTWORK_CACHE_MAGIC;
+
+    // Drop index entries whose file is gone or bad
+    for (CacheEntry& e : gIndex.entries) {
+        e.key[ARTWORK_KEY_LEN - 1] = '\0';
+        if (!e.key[0]) continue;
+        char path[48];
+        entry_path(path, sizeof(path), e.key);
+        File ef = artwork_cache_valid_key(e.key) ? LittleFS.open(path, "r") : File();
+        if (!ef || ef.size() != ARTWORK_I8_SIZE) memset(&e, 0, sizeof(e));
+        if (ef) ef.close();
+    }
+
+    // Remove files the index does not know about (e.g. power loss mid-store),
+    // and RGB565 entries left by older firmware
+    File dir = LittleFS.open(ARTWORK_CACHE_DIR);
+    if (dir) {
+        for (File ef = dir.openNextFile(); ef; ef = dir.openNextFile()) {
+            char name[48];
+            strncpy(name, ef.name(), sizeof(name) - 1);
+            name[sizeof(name) - 1] = '\0';
+            ef.close();
+
+            char* dot = strrchr(name, '.');
+            if (!dot || (strcmp(dot, ".i8") != 0 && strcmp(dot, ".565") != 0)) continue;
+            char path[64];
+            snprintf(path, sizeof(path), ARTWORK_CACHE_DIR "/%s", name);
+            bool legacy = strcmp(dot, ".565") == 0;
+            *dot = '\0';
+            if (legacy || !find_entry(name)) LittleFS.remove(path);
+        }
+        dir.close();
+    }
+
+    // Shrink to the budget if the partition got smaller
+    while (used_entries() > gMaxEntries) evict_lru();
+    flush_index();
+
+    gCacheReady = true;
+    Serial.printf("[ARTCACHE] Ready: %d/%d entries, %u/%u bytes used\n",
+                  used_entries(), gMaxEntries, (unsigned)LittleFS.usedBytes(), (unsigned)LittleFS.totalBytes());
+    return true;
+}
+
+bool artwork_cache_contains(const char* key) {
+    return gCacheReady && artwork_cache_valid_key(key) && find_entry(key);
+}
+
+bool artwork_cache_load(const char* key, uint8_t* dst) {
+    if (!gCacheReady || !artwork_cache_valid_key(key)) return false;
+    CacheEntry* e = find_entry(key);
+    if (!e) return false;
+
+    uint32_t t0 = micros();
+    char path[48];
+    entry_path(path, sizeof(path), key);
+    File f = LittleFS.open(path, "r");
+    size_t got = f ? f.read(dst, ARTWORK_I8_SIZE) : 0;
+    if (f) f.close();
+    if (got != ARTWORK_I8_SIZE) {
+        Serial.printf("[ARTCACHE] %s unreadable, dropping\n", key);
+        LittleFS.remove(path);
+        memset(e, 0, sizeof(*e));
+        flush_index();
+        return false;
+    }
+
+    e->lastUse = ++gIndex.tick;
+    gIndexDirty = true;
+    maybe_flush_index();
+    Serial.printf("[ARTCACHE] Hit %s in %u us\n", key, micros() - t0);
+    return true;
+}
+
+void artwork_cache_store(const char* key, const uint8_t* image) {
+    if (!gCacheReady || !artwork_cache_valid_key(key)) return;
+
+    CacheEntry* e = find_entry(key);
+    if (e) {
+        // Already cached: never rewrite the file, just refresh its LRU position
+        e->lastUse = ++gIndex.tick;
+        gIndexDirty = true;
+        maybe_flush_index();
+        return;
+    }
+
+    while (used_entries() >= gMaxEntries && used_entries() > 0) evict_lru();
+    while (LittleFS.totalBytes() - LittleFS.usedBytes() < ARTWORK_CACHE_ENTRY_COST * 2 && used_entries() > 0) {
+        evict_lru();  // Keep headroom for LittleFS copy-on-write metadata
+    }
+    if (gMaxEntries == 0) return;
+
+    char path[48];
+    entry_path(path, sizeof(path), key);
+    File f = LittleFS.open(path, "w");
+    size_t wrote = f ? f.write(image, ARTWORK_I8_SIZE) : 0;
+    if (f) f.close();
+    if (wrote != ARTWORK_I8_SIZE) {
+        Serial.printf("[ARTCACHE] Write of %s failed\n", key);
+        LittleFS.remove(path);
+        return;
+    }
+
+    for (CacheEntry& slot : gIndex.entries) {
+        if (slot.key[0]) continue;
+        strncpy(slot.key, key, ARTWORK_KEY_LEN - 1);
+        slot.lastUse = ++gIndex.tick;
+        break;
+    }
+    flush_index();
+    Serial.printf("[ARTCACHE] Stored %s (%d/%d)\n", key, used_entries(), gMaxEntries);
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <Arduino.h>
+#include "data_model.h"
+
+// Longest cache key + NUL (Spotify album IDs are 22 chars, hashes 8 hex digits)
+#define ARTWORK_KEY_LEN 24
+
+// Mount LittleFS (formatting it if needed) and load the cache index.
+// Safe to skip: every other call is a no-op/miss until this succeeds.
+bool artwork_cache_init();
+
+// True if key is 1..ARTWORK_KEY_LEN-1 chars of [A-Za-z0-9_-] (it becomes a file name)
+bool artwork_cache_valid_key(const char* key);
+
+// True if key is in the index (index lookup only, no flash read)
+bool artwork_cache_contains(const char* key);
+
+// Copy a cached image (ARTWORK_I8_SIZE bytes) into dst. False on a miss.
+bool artwork_cache_load(const char* key, uint8_t* dst);
+
+// Add an image under key, evicting least-recently-used entries to stay in budget
+void artwork_cache_store(const char* key, const uint8_t* image);
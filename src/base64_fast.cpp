@@ -0,0 +1,98 @@
+/**
+ * @file base64_fast.cpp
+ * Table-driven base64 decoder for artwork payloads
+ *
+ * mbedtls_base64_decode looks every character up in constant time, which
+ * costs several times more than a plain table read. Artwork is not secret,
+ * so this decoder trades that for one 256-byte table and a 32-bit load per
+ * quad. Assumes a little-endian target (ESP32, x86).
+ */
+
+#include "base64_fast.h"
+#include <string.h>
+
+#define B64_INVALID 0x80
+
+// Maps an input byte to its 6-bit value, B64_INVALID for anything else ('=' included)
+static const uint8_t kB64Dec[256] = {
+#define X B64_INVALID
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, 62, X, X, X, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, X, X, X, X, X, X,
+    X, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, X, X, X, X, X,
+    X, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+#undef X
+};
+
+size_t b64_decoded_len(const char* in, size_t inLen) {
+    if (inLen == 0 || (inLen & 3) != 0) return 0;
+    size_t n = inLen / 4 * 3;
+    if (in[inLen - 1] == '=') n--;
+    if (in[inLen - 2] == '=') n--;
+    return n;
+}
+
+// Decode one quad held in a little-endian word; false if any char is invalid
+static inline bool decode_quad(uint32_t w, uint8_t* out) {
+    uint32_t a = kB64Dec[w & 0xFF];
+    uint32_t b = kB64Dec[(w >> 8) & 0xFF];
+    uint32_t c = kB64Dec[(w >> 16) & 0xFF];
+    uint32_t d = kB64Dec[w >> 24];
+    if ((a | b | c | d) & B64_INVALID) return false;
+
+    uint32_t v = (a << 18) | (b << 12) | (c << 6) | d;
+    out[0] = (uint8_t)(v >> 16);
+    out[1] = (uint8_t)(v >> 8);
+    out[2] = (uint8_t)v;
+    return true;
+}
+
+bool b64_decode_fast(const char* in, size_t inLen, uint8_t* out, size_t outCap, size_t* outLen) {
+    if (outLen) *outLen = 0;
+    if (inLen == 0) return true;
+    if ((inLen & 3) != 0) return false;
+
+    size_t total = b64_decoded_len(in, inLen);
+    if (total > outCap) return false;
+
+    // All quads but the last carry no padding
+    size_t quads = inLen / 4 - 1;
+    const uint8_t* src = (const uint8_t*)in;
+    uint8_t* dst = out;
+
+    // Quads are read through memcpy, so src may have any alignment
+    for (size_t q = 0; q < quads; ++q, dst += 3) {
+        uint32_t w;
+        memcpy(&w, src + q * 4, 4);
+        if (!decode_quad(w, dst)) return false;
+    }
+
+    // Last quad: "xxxx", "xxx=" or "xx=="
+    const uint8_t* t = src + quads * 4;
+    uint32_t a = kB64Dec[t[0]];
+    uint32_t b = kB64Dec[t[1]];
+    uint32_t c = (t[2] == '=') ? 0 : kB64Dec[t[2]];
+    uint32_t d = (t[3] == '=') ? 0 : kB64Dec[t[3]];
+    if ((a | b | c | d) & B64_INVALID) return false;
+    if (t[2] == '=' && t[3] != '=') return false;
+
+    uint32_t v = (a << 18) | (b << 12) | (c << 6) | d;
+    size_t tail = total - quads * 3;
+    dst[0] = (uint8_t)(v >> 16);
+    if (tail > 1) dst[1] = (uint8_t)(v >> 8);
+    if (tail > 2) dst[2] = (uint8_t)v;
+
+    if (outLen) *outLen = total;
+    return true;
+}
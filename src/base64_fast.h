@@ -0,0 +1,12 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Decoded size of a padded base64 string (0 if inLen is not a multiple of 4)
+size_t b64_decoded_len(const char* in, size_t inLen);
+
+// Decode standard padded base64 (RFC 4648 alphabet, no whitespace) into out.
+// Works a quad at a time: one 32-bit load -> four table lookups -> 3 bytes.
+// Returns false on malformed input or if the result would exceed outCap;
+// out may be partially written in that case.
+bool b64_decode_fast(const char* in, size_t inLen, uint8_t* out, size_t outCap, size_t* outLen);
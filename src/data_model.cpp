@@ -1,414 +1,101 @@
 #include "data_model.h"
-#include <ArduinoJson.h>
-#include "mbedtls/base64.h"
-#include "ui.h"
+#include "snapshot_parser.h"
 #include <WiFi.h>
 #include <WiFiClient.h>
+#include <atomic>
 
-QueueHandle_t gSnapshotQueue = nullptr;
 static String gSerialLineBuf;
 
-// Command queue for sending to Python server (non-blocking)
-static QueueHandle_t gCommandQueue = nullptr;
-#define CMD_QUEUE_SIZE 8
-#define CMD_MAX_LEN 128
-
-// Global artwork buffer (decoded RGB565) - NOT in the queue
-static uint8_t gArtworkRgb565[ARTWORK_RGB565_SIZE];
-static bool gArtworkNew = false;
-static uint32_t gLastArtworkHash = 0;
-
-// Simple hash for change detection
-static uint32_t quickHash(const char* str, size_t len) {
-    uint32_t h = 2166136261u;
-    size_t maxLen = len > 100 ? 100 : len;
-    for (size_t i = 0; i < maxLen; ++i) {
-        h ^= (uint8_t)str[i];
-        h *= 16777619u;
+// Snapshot hand-off: lock-free triple buffer. The ingest task parses straight
+// into its own slot and publishes it by swapping it with the shared middle
+// slot; loop() swaps the middle slot with its own to take the newest
+// snapshot. Each slot is only ever touched by its current owner, so nothing
+// is copied and a snapshot can never be seen half-written. Only one ingest
+// task (Serial or WiFi) runs at a time.
+#define SNAP_FRESH 0x80                        // Middle slot holds an untaken snapshot
+static SnapshotMsg gSnapSlots[3];
+static uint8_t gSnapWrite = 0;                 // Ingest task's slot
+static std::atomic<uint8_t> gSnapMiddle{1};    // Slot index | SNAP_FRESH
+static uint8_t gSnapRead = 2;                  // loop()'s slot
+
+// Structural lane: SPSC ring of queue/playlist changes. The ingest task posts
+// an entry whenever a snapshot's queue or playlist generation differs from
+// the last one it posted; if loop() has fallen behind and the ring is full,
+// the change waits for the next snapshot (which still differs) rather than
+// overwrite one loop() has not applied yet.
+static StructuralMsg gStructRing[STRUCTURAL_QUEUE_LEN];
+static std::atomic<uint8_t> gStructHead{0};    // Next slot the ingest task writes
+static std::atomic<uint8_t> gStructTail{0};    // Oldest slot loop() has not released
+static bool gStructHeld = false;               // loop() is still reading the tail slot
+static ModelGens gStructPosted = {};           // Ingest task: generations already posted
+
+static void post_structural(const SnapshotMsg &msg) {
+    uint8_t domains = 0;
+    if (msg.gens.gen[DOMAIN_QUEUE] != gStructPosted.gen[DOMAIN_QUEUE]) domains |= DOMAIN_BIT(DOMAIN_QUEUE);
+    if (msg.gens.gen[DOMAIN_PLAYLIST] != gStructPosted.gen[DOMAIN_PLAYLIST]) domains |= DOMAIN_BIT(DOMAIN_PLAYLIST);
+    if (!domains) return;
+
+    uint8_t head = gStructHead.load(std::memory_order_relaxed);
+    uint8_t next = (head + 1) % STRUCTURAL_QUEUE_LEN;
+    if (next == gStructTail.load(std::memory_order_acquire)) {
+        Serial.println("[DATA] Structural lane full, change deferred to the next snapshot");
+        return;
     }
-    return h ^ len;
-}
 
-uint8_t* artwork_get_rgb565_buffer() {
-    return gArtworkRgb565;
-}
-
-bool artwork_is_new() {
-    return gArtworkNew;
-}
-
-void artwork_clear_new() {
-    gArtworkNew = false;
-}
-
-// Helper to safely copy Strings into fixed buffers
-static void safeStrCopy(char *dst, size_t dstSize, const String &src) {
-    if (dstSize == 0) return;
-    size_t n = src.length();
-    if (n >= dstSize) n = dstSize - 1;
-    memcpy(dst, src.c_str(), n);
-    dst[n] = '\0';
-}
-
-// Decode base64 artwork directly into global buffer
-static bool decodeArtworkB64(const char* b64, size_t b64Len) {
-    // Check if it's the same artwork
-    uint32_t h = quickHash(b64, b64Len);
-    if (h == gLastArtworkHash) {
-        Serial.println("[ARTWORK] Same hash, skipping");
-        return false;  // Same artwork, no update needed
+    StructuralMsg &s = gStructRing[head];
+    s.domains = domains;
+    s.gens = msg.gens;
+    s.hasQueue = msg.hasQueue;
+    s.queueLen = msg.queueLen;
+    memset(s.queue, 0, sizeof(s.queue));
+    for (uint8_t i = 0; i < msg.queueLen; ++i) {
+        const SnapQueueItem &q = msg.queue[i];
+        QueueItem &item = s.queue[i];
+        model_copy_str(item.id, sizeof(item.id), snapshot_str(msg, q.id));
+        model_copy_str(item.source, sizeof(item.source), snapshot_str(msg, q.source));
+        model_copy_str(item.name, sizeof(item.name), snapshot_str(msg, q.name));
+        model_copy_str(item.artist, sizeof(item.artist), snapshot_str(msg, q.artist));
+        model_copy_str(item.album, sizeof(item.album), snapshot_str(msg, q.album));
+        item.duration = q.duration;
+        item.isLocal = q.isLocal;
     }
-    
-    Serial.printf("[ARTWORK] Decoding %d chars...\n", b64Len);
-    
-    size_t outLen = 0;
-    int ret = mbedtls_base64_decode(
-        gArtworkRgb565,
-        sizeof(gArtworkRgb565),
-        &outLen,
-        (const unsigned char*)b64,
-        b64Len
-    );
-    
-    if (ret != 0 || outLen != ARTWORK_RGB565_SIZE) {
-        Serial.printf("[ARTWORK] Decode failed: ret=%d, outLen=%d (expected %d)\n", ret, outLen, ARTWORK_RGB565_SIZE);
-        return false;
-    }
-    
-    gLastArtworkHash = h;
-    gArtworkNew = true;
-    Serial.printf("[ARTWORK] Decode success! %d bytes, gArtworkNew=true\n", outLen);
-    return true;
+    s.hasPlaylist = msg.hasPlaylist;
+    PlaylistInfo &pl = s.playlist;
+    model_copy_str(pl.id, sizeof(pl.id), snapshot_str(msg, msg.playlist.id));
+    model_copy_str(pl.name, sizeof(pl.name), snapshot_str(msg, msg.playlist.name));
+    model_copy_str(pl.snapshotId, sizeof(pl.snapshotId), snapshot_str(msg, msg.playlist.snapshotId));
+    pl.totalTracks = msg.playlist.totalTracks;
+    pl.isPublic = msg.playlist.isPublic;
+    pl.isCollaborative = msg.playlist.isCollaborative;
+    pl.hasImage = msg.playlist.hasImage;
+    gStructHead.store(next, std::memory_order_release);
+
+    gStructPosted.gen[DOMAIN_QUEUE] = msg.gens.gen[DOMAIN_QUEUE];
+    gStructPosted.gen[DOMAIN_PLAYLIST] = msg.gens.gen[DOMAIN_PLAYLIST];
 }
 
-// Parse JSON line into SnapshotMsg (POD struct) - artwork handled separately
-static bool parse_json_into_msg(const String &input, SnapshotMsg &msg) {
-    // Check if this is a standalone artwork message
-    if (input.indexOf("artwork_b64") > 0 && input.indexOf("cpu_percent") < 0) {
-        Serial.printf("[DATA] Received artwork message (%d chars)\n", input.length());
-        
-        // Debug: print first 100 chars of input
-        Serial.printf("[DATA] First 100 chars: %.100s\n", input.c_str());
-        
-        // Extract base64 directly without JSON parsing to save memory
-        // Format: {"artwork_b64":"BASE64DATA"} or {"artwork_b64": "BASE64DATA"}
-        int startIdx = input.indexOf("\"artwork_b64\"");
-        if (startIdx < 0) {
-            Serial.println("[DATA] No artwork_b64 key found");
-            return false;
-        }
-        
-        // Find the colon after artwork_b64
-        int colonIdx = input.indexOf(":", startIdx);
-        if (colonIdx < 0) {
-            Serial.println("[DATA] No colon after artwork_b64");
-            return false;
-        }
-        
-        // Find the opening quote after the colon
-        int quoteIdx = input.indexOf("\"", colonIdx + 1);
-        if (quoteIdx < 0) {
-            Serial.println("[DATA] No opening quote for value");
-            return false;
-        }
-        startIdx = quoteIdx + 1;  // Start of base64 data
-        
-        int endIdx = input.indexOf("\"", startIdx);
-        if (endIdx < 0 || endIdx <= startIdx) {
-            Serial.println("[DATA] Malformed artwork JSON - no closing quote");
-            return false;
-        }
-        
-        size_t b64len = endIdx - startIdx;
-        Serial.printf("[DATA] artwork_b64 length: %d\n", b64len);
-        
-        if (b64len > 100 && b64len < 20000) {
-            // Get pointer to base64 data in the input string
-            const char* b64 = input.c_str() + startIdx;
-            bool ok = decodeArtworkB64(b64, b64len);
-            Serial.printf("[DATA] Artwork decode: %s\n", ok ? "SUCCESS" : "FAILED");
-        } else {
-            Serial.printf("[DATA] artwork_b64 invalid length: %d\n", b64len);
-        }
-        return false;  // Don't queue this as a snapshot
-    }
-
-    // If the message is a one-off 'ack' command (acknowledgement), apply quick UI updates
-    // Parse minimal JSON for ack
-    if (input.indexOf("\"ack\"") > 0) {
-        DynamicJsonDocument ackDoc(256);
-        DeserializationError ackErr = deserializeJson(ackDoc, input);
-        if (!ackErr && ackDoc.containsKey("ack")) {
-            const char* ackVal = ackDoc["ack"] | "";
-            if (strcmp(ackVal, "play") == 0) {
-                ui_set_play_state(true);
-            } else if (strcmp(ackVal, "pause") == 0) {
-                ui_set_play_state(false);
-            }
-        }
-        return false; // Not a full snapshot
-    }
-    
-    // Regular system snapshot - need larger buffer for queue data
-    DynamicJsonDocument doc(6144);
-    
-    DeserializationError err = deserializeJson(doc, input);
-    if (err) {
-        return false;
-    }
-
-    // --- System ---
-    float cpu = 0.0f;
-    if (doc.containsKey("cpu_percent_total"))
-        cpu = doc["cpu_percent_total"].as<float>();
-    else if (doc.containsKey("cpu_percent"))
-        cpu = doc["cpu_percent"].as<float>();
-    msg.cpu = cpu;
-    msg.mem = doc.containsKey("mem_percent") ? doc["mem_percent"].as<float>() : 0.0f;
-    msg.gpu = doc.containsKey("gpu_percent") ? doc["gpu_percent"].as<float>() : 0.0f;
-
-    msg.procCount = 0;
-    for (int i = 0; i < 5; ++i) {
-        msg.procs[i][0] = '\0';
-        msg.procPids[i] = 0;
-    }
-
-    // Parse proc_top5 (rich objects) or fallback to cpu_top5_process (legacy string list)
-    if (doc.containsKey("proc_top5") && doc["proc_top5"].is<JsonArray>()) {
-        JsonArray arr = doc["proc_top5"].as<JsonArray>();
-        uint8_t idx = 0;
-        for (JsonVariant v : arr) {
-            if (idx >= 5) break;
-            if (v.is<JsonObject>()) {
-                JsonObject o = v.as<JsonObject>();
-                int pid = o["pid"] | 0;
-                float mem = o["mem"] | 0.0f;
-                const char *name = o["name"] | "";
-                const char *display = o["display_name"] | name;
-                char buf[32];
-                // Display string should hide PID and remove ".exe" suffix
-                // The Python backend provides `display_name`, but fallback to `name`.
-                snprintf(buf, sizeof(buf), "%.1f%% %s", mem, display);
-                safeStrCopy(msg.procs[idx], sizeof(msg.procs[idx]), String(buf));
-                msg.procPids[idx] = pid;
-                idx++;
-            }
-        }
-        msg.procCount = idx;
-    } else if (doc.containsKey("cpu_top5_process")) {
-        JsonVariant procs = doc["cpu_top5_process"];
-        if (procs.is<JsonArray>()) {
-            JsonArray arr = procs.as<JsonArray>();
-            uint8_t idx = 0;
-                for (JsonVariant v : arr) {
-                if (idx >= 5) break;
-                String line;
-                if (v.is<const char*>()) {
-                    line = String(v.as<const char*>());
-                } else {
-                    serializeJson(v, line);
-                }
-                // Try to strip PID/EXE in fallback string
-                // If line contains a percent and text, we assume it's in format "<mem>% <name>"
-                // Keep as-is but remove .exe if present
-                String clean = line;
-                // Remove .exe suffixs in fallback
-                int posExe = clean.indexOf(".exe");
-                if (posExe >= 0) {
-                    // remove .exe
-                    clean.remove(posExe, 4);
-                }
-                safeStrCopy(msg.procs[idx], sizeof(msg.procs[idx]), clean);
-                msg.procPids[idx] = 0; // unknown PID in fallback
-                idx++;
-            }
-            msg.procCount = idx;
-        }
-    }
-
-    // --- Media (optional "media" object from Python) ---
-    msg.hasMedia = false;
-    msg.hasArtwork = false;
-    msg.artworkUpdated = false;
-    msg.title[0]  = '\0';
-    msg.artist[0] = '\0';
-    msg.album[0]  = '\0';
-    msg.source[0] = '\0';
-    msg.trackUri[0] = '\0';
-    msg.position  = 0;
-    msg.duration  = 0;
-    msg.isPlaying = false;
-    msg.shuffle = false;
-    msg.repeat = 0;
-    msg.isLiked = false;
-    
-    // Initialize queue/playlist
-    msg.hasQueue = false;
-    msg.queueLen = 0;
-    msg.hasPlaylist = false;
-    memset(&msg.playlist, 0, sizeof(msg.playlist));
-    for (int i = 0; i < MAX_QUEUE_ITEMS; ++i) {
-        memset(&msg.queue[i], 0, sizeof(QueueItem));
-    }
-
-    if (doc.containsKey("media") && doc["media"].is<JsonObject>()) {
-        JsonObject media = doc["media"].as<JsonObject>();
-        String title  = String(media["title"]   | "No media");
-        String artist = String(media["artist"]  | "");
-        String album  = String(media["album"]   | "");
-        String source = String(media["source"]  | "");
-        String trackUri = String(media["track_uri"] | "");
-        int pos       = media["position_seconds"]  | 0;
-        int dur       = media["duration_seconds"]  | 0;
-        bool playing  = media["is_playing"] | false;
-        bool shuffle  = media["shuffle"] | false;
-        bool isLiked  = media["is_liked"] | false;
-        
-        // Parse repeat state: "off", "track", "context"
-        String repeatStr = String(media["repeat"] | "off");
-        uint8_t repeat = 0;  // off
-        if (repeatStr == "track") repeat = 1;
-        else if (repeatStr == "context") repeat = 2;
-
-        safeStrCopy(msg.title,  sizeof(msg.title),  title);
-        safeStrCopy(msg.artist, sizeof(msg.artist), artist);
-        safeStrCopy(msg.album,  sizeof(msg.album),  album);
-        safeStrCopy(msg.source, sizeof(msg.source), source);
-        safeStrCopy(msg.trackUri, sizeof(msg.trackUri), trackUri);
-        msg.position = pos;
-        msg.duration = dur;
-        msg.isPlaying = playing;
-        msg.shuffle = shuffle;
-        msg.repeat = repeat;
-        msg.isLiked = isLiked;
-        msg.hasMedia = true;
-        
-        // Parse playlist context if present
-        if (media.containsKey("playlist") && media["playlist"].is<JsonObject>()) {
-            JsonObject pl = media["playlist"].as<JsonObject>();
-            msg.hasPlaylist = true;
-            safeStrCopy(msg.playlist.id, sizeof(msg.playlist.id), String(pl["id"] | ""));
-            safeStrCopy(msg.playlist.name, sizeof(msg.playlist.name), String(pl["name"] | ""));
-            safeStrCopy(msg.playlist.snapshotId, sizeof(msg.playlist.snapshotId), String(pl["snapshot_id"] | ""));
-            msg.playlist.totalTracks = pl["total_tracks"] | 0;
-            msg.playlist.isPublic = pl["is_public"] | false;
-            msg.playlist.isCollaborative = pl["is_collaborative"] | false;
-            msg.playlist.hasImage = pl.containsKey("image_thumb_jpg_b64") && strlen(pl["image_thumb_jpg_b64"] | "") > 0;
-        }
-        
-        // Parse queue if present
-        if (media.containsKey("queue") && media["queue"].is<JsonArray>()) {
-            JsonArray qArr = media["queue"].as<JsonArray>();
-            msg.hasQueue = true;
-            uint8_t idx = 0;
-            for (JsonVariant v : qArr) {
-                if (idx >= MAX_QUEUE_ITEMS) break;
-                if (!v.is<JsonObject>()) continue;
-                JsonObject q = v.as<JsonObject>();
-                
-                QueueItem &item = msg.queue[idx];
-                safeStrCopy(item.id, sizeof(item.id), String(q["id"] | ""));
-                safeStrCopy(item.source, sizeof(item.source), String(q["source"] | "spotify"));
-                safeStrCopy(item.name, sizeof(item.name), String(q["name"] | ""));
-                safeStrCopy(item.artist, sizeof(item.artist), String(q["artist"] | ""));
-                safeStrCopy(item.album, sizeof(item.album), String(q["album"] | ""));
-                item.duration = q["duration_seconds"] | 0;
-                item.isLocal = q["is_local"] | false;
-                idx++;
-            }
-            msg.queueLen = idx;
-        }
-        
-        // Decode artwork directly into global buffer (not queued)
-        if (media.containsKey("artwork_png_b64")) {
-            const char* b64 = media["artwork_png_b64"] | "";
-            size_t b64len = strlen(b64);
-            if (b64len > 0) {
-                msg.hasArtwork = true;
-                if (decodeArtworkB64(b64, b64len)) {
-                    msg.artworkUpdated = true;
-                }
-            }
-        }
-    }
+// UI event mailbox: a ring with one writer per index. Only the ingest task
+// moves the head and only loop() moves the tail; one slot stays empty so a
+// full ring is distinguishable from an empty one.
+static UiEvent gUiEvents[UI_EVENT_QUEUE_LEN];
+static std::atomic<uint8_t> gUiEventHead{0};   // Next slot the ingest task writes
+static std::atomic<uint8_t> gUiEventTail{0};   // Next slot loop() reads
 
-    // --- Discord voice call state (optional "discord" object) ---
-    msg.hasDiscord = false;
-    memset(&msg.discord, 0, sizeof(msg.discord));
-    
-    if (doc.containsKey("discord") && doc["discord"].is<JsonObject>()) {
-        JsonObject discord = doc["discord"].as<JsonObject>();
-        
-        // Check if in call - support both "c" (compact) and "in_call" (full)
-        bool inCall = false;
-        if (discord.containsKey("c")) {
-            inCall = discord["c"].as<int>() != 0;
-        } else if (discord.containsKey("in_call")) {
-            inCall = discord["in_call"] | false;
-        }
-        
-        msg.discord.inCall = inCall;
-        
-        if (inCall) {
-            msg.hasDiscord = true;
-            
-            // Channel name - support both "ch" (compact) and "channel" (full)
-            String channelName = "";
-            if (discord.containsKey("ch")) {
-                channelName = String(discord["ch"] | "");
-            } else if (discord.containsKey("channel")) {
-                channelName = String(discord["channel"] | "");
-            }
-            safeStrCopy(msg.discord.channelName, sizeof(msg.discord.channelName), channelName);
-            
-            // Self mute/deaf - support both compact and full
-            msg.discord.selfMuted = discord["sm"] | discord["self_muted"] | false;
-            msg.discord.selfDeafened = discord["sd"] | discord["self_deafened"] | false;
-            
-            // Parse users array - support both "u" (compact) and "users" (full)
-            JsonArray usersArr;
-            if (discord.containsKey("u") && discord["u"].is<JsonArray>()) {
-                usersArr = discord["u"].as<JsonArray>();
-            } else if (discord.containsKey("users") && discord["users"].is<JsonArray>()) {
-                usersArr = discord["users"].as<JsonArray>();
-            }
-            
-            uint8_t idx = 0;
-            for (JsonVariant v : usersArr) {
-                if (idx >= MAX_DISCORD_USERS) break;
-                if (!v.is<JsonObject>()) continue;
-                JsonObject u = v.as<JsonObject>();
-                
-                DiscordUser &user = msg.discord.users[idx];
-                
-                // Name - support both "n" (compact) and "name" (full)
-                String name = "";
-                if (u.containsKey("n")) {
-                    name = String(u["n"] | "");
-                } else if (u.containsKey("name")) {
-                    name = String(u["name"] | "");
-                }
-                safeStrCopy(user.name, sizeof(user.name), name);
-                
-                // Muted - support both "m" (compact) and "muted" (full)
-                user.muted = u["m"] | u["muted"] | false;
-                
-                // Deafened - support both "d" (compact) and "deafened" (full)
-                user.deafened = u["d"] | u["deafened"] | false;
-                
-                // Speaking - support both "s" (compact) and "speaking" (full)
-                user.speaking = u["s"] | u["speaking"] | false;
-                
-                idx++;
-            }
-            msg.discord.userCount = idx;
-        }
-    }
+// Command queue for sending to Python server (non-blocking)
+static QueueHandle_t gCommandQueue = nullptr;
+#define CMD_QUEUE_SIZE 8
+#define CMD_MAX_LEN 128
 
-    return true;
+// Parse a line in place into the ingest slot; if it was a snapshot, post its
+// queue/playlist changes to the structural lane and publish it as telemetry
+static void ingest_line(const String &line) {
+    if (!parse_json_into_msg(line, gSnapSlots[gSnapWrite])) return;
+    post_structural(gSnapSlots[gSnapWrite]);
+    uint8_t prev = gSnapMiddle.exchange(gSnapWrite | SNAP_FRESH, std::memory_order_acq_rel);
+    gSnapWrite = prev & ~SNAP_FRESH;  // An untaken older snapshot is simply reused
 }
 
-// RTOS task: producer – reads Serial, parses JSON, sends SnapshotMsg to queue
+// RTOS task: producer – reads Serial, parses JSON, publishes SnapshotMsg
 static void serial_task(void *pvParameters) {
     (void) pvParameters;
 
@@ -422,12 +109,7 @@ static void serial_task(void *pvParameters) {
                 line.trim();
 
                 if (line.length() > 5) {
-                    SnapshotMsg msg;
-                    if (parse_json_into_msg(line, msg)) {
-                        if (gSnapshotQueue) {
-                            xQueueOverwrite(gSnapshotQueue, &msg);
-                        }
-                    }
+                    ingest_line(line);
                 }
             } else if (c != '\r') {
                 gSerialLineBuf += c;
@@ -442,7 +124,6 @@ static void serial_task(void *pvParameters) {
 }
 
 void data_model_init() {
-    gSnapshotQueue = xQueueCreate(1, sizeof(SnapshotMsg));
     gCommandQueue = xQueueCreate(CMD_QUEUE_SIZE, CMD_MAX_LEN);
     if (!gCommandQueue) {
         Serial.println("[data_model] Failed to create command queue!");
@@ -453,18 +134,8 @@ void data_model_init() {
 static uint32_t gLastCommandMs = 0;
 static const uint32_t COMMAND_MIN_INTERVAL_MS = 150;  // Min 150ms between commands
 
-// Non-blocking command send - sends via Serial immediately (most reliable)
-void send_command(const char* cmd) {
-    if (!cmd) return;
-    
-    // Throttle commands to prevent heap fragmentation from rapid clicks
-    uint32_t now = millis();
-    if (now - gLastCommandMs < COMMAND_MIN_INTERVAL_MS) {
-        Serial.println("[CMD] Throttled");
-        return;
-    }
-    gLastCommandMs = now;
-    
+// Write one line to the server over Serial and (if connected) WiFi
+static void write_line(const char* cmd) {
     // Ensure newline termination
     size_t len = strlen(cmd);
     bool has_newline = (len > 0 && cmd[len - 1] == '\n');
@@ -486,6 +157,27 @@ void send_command(const char* cmd) {
     }
 }
 
+// Non-blocking command send - sends via Serial immediately (most reliable)
+void send_command(const char* cmd) {
+    if (!cmd) return;
+    
+    // Throttle commands to prevent heap fragmentation from rapid clicks
+    uint32_t now = millis();
+    if (now - gLastCommandMs < COMMAND_MIN_INTERVAL_MS) {
+        Serial.println("[CMD] Throttled");
+        return;
+    }
+    gLastCommandMs = now;
+    
+    write_line(cmd);
+}
+
+// Protocol replies are not user clicks: never throttled
+void send_reply(const char* msg) {
+    if (!msg) return;
+    write_line(msg);
+}
+
 void start_serial_task() {
     xTaskCreatePinnedToCore(
         serial_task,
@@ -604,16 +296,11 @@ static void wifi_task(void *pvParameters) {
                             vTaskDelay(pdMS_TO_TICKS(1));
                             
                             size_t freeHeap = ESP.getFreeHeap();
-                            bool isArtwork = lineBuf.indexOf("artwork_b64") > 0;
+                            bool isArtwork = is_artwork_line(lineBuf);
                             
                             // Skip artwork if low memory
                             if (freeHeap > 40000 || !isArtwork) {
-                                SnapshotMsg msg;
-                                if (parse_json_into_msg(lineBuf, msg)) {
-                                    if (gSnapshotQueue) {
-                                        xQueueOverwrite(gSnapshotQueue, &msg);
-                                    }
-                                }
+                                ingest_line(lineBuf);
                                 // Yield after parsing
                                 vTaskDelay(pdMS_TO_TICKS(1));
                             } else {
@@ -662,8 +349,67 @@ void start_wifi_task(const char* host, uint16_t port) {
     );
 }
 
-bool data_model_try_dequeue(SnapshotMsg &msg) {
-    if (!gSnapshotQueue) return false;
-    BaseType_t ok = xQueueReceive(gSnapshotQueue, &msg, 0);  // no block
-    return (ok == pdTRUE);
+uint32_t model_copy_str(char *dst, size_t dstSize, const char *src) {
+    uint32_t h = 2166136261u;
+    if (dstSize == 0) return h;
+    size_t len = 0;
+    while (len + 1 < dstSize && src[len]) ++len;
+    if (src[len]) len = utf8_clip(src, len);
+    for (size_t n = 0; n < len; ++n) {
+        dst[n] = src[n];
+        h = (h ^ (uint8_t)src[n]) * 16777619u;
+    }
+    dst[len] = '\0';
+    return h;
+}
+
+uint8_t model_take_dirty(const ModelGens &now, ModelGens &seen) {
+    uint8_t dirty = 0;
+    for (int d = 0; d < DOMAIN_COUNT; ++d) {
+        if (now.gen[d] == seen.gen[d]) continue;
+        seen.gen[d] = now.gen[d];
+        dirty |= DOMAIN_BIT(d);
+    }
+    return dirty;
+}
+
+bool ui_event_post(UiEventType type, int32_t value) {
+    uint8_t head = gUiEventHead.load(std::memory_order_relaxed);
+    uint8_t next = (head + 1) % UI_EVENT_QUEUE_LEN;
+    if (next == gUiEventTail.load(std::memory_order_acquire)) {
+        Serial.printf("[DATA] UI event queue full, dropped event %d\n", type);
+        return false;
+    }
+    gUiEvents[head].type = type;
+    gUiEvents[head].value = value;
+    gUiEventHead.store(next, std::memory_order_release);
+    return true;
+}
+
+bool ui_event_take(UiEvent &ev) {
+    uint8_t tail = gUiEventTail.load(std::memory_order_relaxed);
+    if (tail == gUiEventHead.load(std::memory_order_acquire)) return false;
+    ev = gUiEvents[tail];
+    gUiEventTail.store((tail + 1) % UI_EVENT_QUEUE_LEN, std::memory_order_release);
+    return true;
+}
+
+const StructuralMsg* data_model_take_structural() {
+    uint8_t tail = gStructTail.load(std::memory_order_relaxed);
+    if (gStructHeld) {
+        // Release the entry handed out by the previous call
+        tail = (tail + 1) % STRUCTURAL_QUEUE_LEN;
+        gStructTail.store(tail, std::memory_order_release);
+        gStructHeld = false;
+    }
+    if (tail == gStructHead.load(std::memory_order_acquire)) return nullptr;
+    gStructHeld = true;
+    return &gStructRing[tail];
+}
+
+const SnapshotMsg* data_model_take_latest() {
+    if (!(gSnapMiddle.load(std::memory_order_acquire) & SNAP_FRESH)) return nullptr;
+    uint8_t prev = gSnapMiddle.exchange(gSnapRead, std::memory_order_acq_rel);
+    gSnapRead = prev & ~SNAP_FRESH;
+    return &gSnapSlots[gSnapRead];
 }
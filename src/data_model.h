@@ -15,11 +15,19 @@
 #define ARTWORK_WIDTH 80
 #define ARTWORK_HEIGHT 80
 #define ARTWORK_RGB565_SIZE (ARTWORK_WIDTH * ARTWORK_HEIGHT * 2)  // 12800 bytes
+// Stored/displayed form: LVGL I8, 256 ARGB8888 palette entries then one index per pixel
+#define ARTWORK_PALETTE_SIZE (256 * 4)
+#define ARTWORK_I8_SIZE (ARTWORK_PALETTE_SIZE + ARTWORK_WIDTH * ARTWORK_HEIGHT)  // 7424 bytes
+// I8 wire payload: 256 RGB565 palette entries then the indices
+#define ARTWORK_I8_WIRE_SIZE (256 * 2 + ARTWORK_WIDTH * ARTWORK_HEIGHT)  // 6912 bytes
 
 // Queue/Playlist limits (memory-constrained)
 #define MAX_QUEUE_ITEMS 5
 #define MAX_STR_ESP 48
 
+// Now-playing title/artist/album, including the terminator
+#define MEDIA_TEXT_LEN 128
+
 // Discord voice call limits
 #define MAX_DISCORD_USERS 5
 #define DISCORD_NAME_LEN 16
@@ -43,11 +51,25 @@ struct DiscordState {
     DiscordUser users[MAX_DISCORD_USERS];
 };
 
+// Length to keep when s must be cut to at most n bytes: n, backed off to the
+// start of the UTF-8 sequence that would otherwise be split
+inline size_t utf8_clip(const char *s, size_t n) {
+    for (int k = 0; k < 3 && n > 0 && ((uint8_t)s[n] & 0xC0) == 0x80; ++k) n--;
+    return n;
+}
+
+// UI model strings are fixed-size arrays (no heap). Process names also keep
+// the FNV-1a hash of their text so the process list compares one word each.
+// Copies src (truncated to fit, on a UTF-8 boundary) into dst and returns the
+// hash of the copy.
+uint32_t model_copy_str(char *dst, size_t dstSize, const char *src);
+
 struct SystemData {
     float cpu = 0.0f;
     float mem = 0.0f;
     float gpu = 0.0f;    // GPU usage percentage
-    String procs[5];
+    char procs[5][32] = {};
+    uint32_t procHash[5] = {};
     int procPids[5];
     uint8_t procCount = 0;
     bool valid = false;
@@ -68,7 +90,7 @@ struct QueueItem {
 struct PlaylistInfo {
     char id[64];
     char name[MAX_STR_ESP];
-    char snapshotId[48];
+    char snapshotId[72];   // Spotify snapshot IDs run to ~70 chars
     uint16_t totalTracks;
     bool isPublic;
     bool isCollaborative;
@@ -76,14 +98,14 @@ struct PlaylistInfo {
 };
 
 struct MediaData {
-    String title;
-    String artist;
-    String album;
+    char title[MEDIA_TEXT_LEN] = "";
+    char artist[MEDIA_TEXT_LEN] = "";
+    char album[MEDIA_TEXT_LEN] = "";
     int position = 0;    // seconds
     int duration = 0;    // seconds
     bool isPlaying = false;
-    String source;       // "spotify", "youtube", "browser"
-    String trackUri;     // Spotify track URI for like/unlike
+    char source[16] = "";    // "spotify", "youtube", "browser"
+    char trackUri[80] = "";  // Spotify track URI for like/unlike
 
     bool hasArtwork = false;
     bool artworkUpdated = false;  // Set true when new artwork is ready
@@ -109,21 +131,71 @@ struct MediaData {
     bool valid = false;
 };
 
-// Keep SnapshotMsg small - no artwork in the queue!
+// Model domains. The parser bumps a domain's generation whenever its content
+// differs from the previous snapshot; consumers compare generations with the
+// ones they last handled, so a change is never missed even when the snapshot
+// that carried it was never taken.
+enum ModelDomain : uint8_t {
+    DOMAIN_SYSTEM,      // cpu/mem/gpu, processes
+    DOMAIN_PLAYBACK,    // Track, position, play/shuffle/repeat/like state
+    DOMAIN_QUEUE,
+    DOMAIN_PLAYLIST,
+    DOMAIN_DISCORD,
+    DOMAIN_ARTWORK,     // A new image was published
+    DOMAIN_COUNT
+};
+#define DOMAIN_BIT(d) (1u << (d))
+
+struct ModelGens {
+    uint32_t gen[DOMAIN_COUNT];
+};
+
+// Dirty bits of the domains whose generation in now differs from seen; seen
+// is brought up to date
+uint8_t model_take_dirty(const ModelGens &now, ModelGens &seen);
+
+// Snapshot strings live in a per-message arena: each field is an offset and
+// length into it, NUL-terminated there. Empty strings all point at arena[0].
+struct StrRef {
+    uint16_t off;
+    uint16_t len;
+};
+
+// Typical snapshots use 100-750 bytes. Identifiers are placed first and always
+// fit; once the arena is full, display text is cut short.
+#define SNAPSHOT_ARENA_SIZE 1024
+
+// Queue item and playlist as parsed; the structural lane turns them into
+// QueueItem/PlaylistInfo
+struct SnapQueueItem {
+    StrRef id, source, name, artist, album;
+    uint16_t duration;     // seconds
+    bool isLocal;
+};
+
+struct SnapPlaylist {
+    StrRef id, name, snapshotId;
+    uint16_t totalTracks;
+    bool isPublic;
+    bool isCollaborative;
+    bool hasImage;
+};
+
+// Keep SnapshotMsg small - no artwork in the snapshot buffers!
 typedef struct {
     float cpu;
     float mem;
     float gpu;           // GPU usage percentage
     uint8_t procCount;
-    char procs[5][32];
+    StrRef procs[5];
     int procPids[5];
 
     bool hasMedia;
-    char title[64];
-    char artist[64];
-    char album[64];
-    char source[16];     // Media source
-    char trackUri[80];   // Spotify track URI for like/unlike
+    StrRef title;
+    StrRef artist;
+    StrRef album;
+    StrRef source;       // Media source
+    StrRef trackUri;     // Spotify track URI for like/unlike
     int position;
     int duration;
     bool isPlaying;
@@ -139,28 +211,83 @@ typedef struct {
     // Queue data
     bool hasQueue;
     uint8_t queueLen;
-    QueueItem queue[MAX_QUEUE_ITEMS];
+    SnapQueueItem queue[MAX_QUEUE_ITEMS];
     
     // Playlist context
     bool hasPlaylist;
-    PlaylistInfo playlist;
+    SnapPlaylist playlist;
     
     // Discord voice call state
     bool hasDiscord;
     DiscordState discord;
+
+    ModelGens gens;        // Domain generations as of this snapshot
+
+    uint16_t arenaUsed;
+    char arena[SNAPSHOT_ARENA_SIZE];
 } SnapshotMsg;
 
-extern QueueHandle_t gSnapshotQueue;
+inline const char* snapshot_str(const SnapshotMsg &msg, StrRef ref) {
+    return msg.arena + ref.off;
+}
 
 void data_model_init();
 void start_serial_task();
 void start_wifi_task(const char* host, uint16_t port);  // WiFi managed by WiFiManager
-bool data_model_try_dequeue(SnapshotMsg &msg);
+// The ingest task hands the model to loop() in three lanes, drained in this
+// order every frame:
+//   immediate  - acks and other UI events (ui_event_post, below)
+//   structural - queue/playlist changes, in arrival order (FIFO)
+//   telemetry  - the rest of the newest snapshot; newer ones overwrite older
+//
+// Telemetry lane: newest snapshot published since the last call, or nullptr.
+// loop() only; the snapshot stays valid and unchanged until the next call.
+// Its queue/playlist fields are superseded by the structural lane.
+const SnapshotMsg* data_model_take_latest();
+
+// Structural lane entry: the queue and playlist as of one snapshot whose
+// queue or playlist generation changed
+struct StructuralMsg {
+    uint8_t domains;        // DOMAIN_BIT(DOMAIN_QUEUE) and/or DOMAIN_BIT(DOMAIN_PLAYLIST)
+    ModelGens gens;         // Generations of the snapshot it came from
+    bool hasQueue;
+    uint8_t queueLen;
+    QueueItem queue[MAX_QUEUE_ITEMS];
+    bool hasPlaylist;
+    PlaylistInfo playlist;
+};
+
+#define STRUCTURAL_QUEUE_LEN 4
+// loop() only: oldest pending structural change, or nullptr once drained.
+// The entry stays valid until the next call.
+const StructuralMsg* data_model_take_structural();
+
+// UI events: what the ingest task needs the UI to do outside a snapshot.
+// LVGL is not thread-safe, so they go through a lock-free single-producer/
+// single-consumer mailbox that loop() drains before rendering.
+enum UiEventType : uint8_t {
+    UI_EVENT_PLAY_STATE,    // value: 1 playing, 0 paused (server ack)
+};
+
+struct UiEvent {
+    UiEventType type;
+    int32_t value;
+};
+
+#define UI_EVENT_QUEUE_LEN 16
+// Ingest task only. False (event dropped) if loop() is this far behind.
+bool ui_event_post(UiEventType type, int32_t value);
+// loop() only: the oldest pending event, if any
+bool ui_event_take(UiEvent &ev);
 
 // Send a command to the Python server (non-blocking, uses WiFi if available)
 void send_command(const char* cmd);
 
-// Artwork buffer access (global static buffer, not in queue)
-uint8_t* artwork_get_rgb565_buffer();
-bool artwork_is_new();
-void artwork_clear_new();
+// Send a protocol reply (e.g. artwork have/need) - same path, but never throttled
+void send_reply(const char* msg);
+
+// Artwork access for the UI (double-buffered, not in queue).
+// If a new image was published since the last call, swap it to the front and
+// return it (I8: palette, then indices); the previous front may be overwritten
+// from then on. Else nullptr.
+const uint8_t* artwork_take_new();
@@ -9,8 +9,11 @@
 #include <XPT2046_Touchscreen.h>
 #include <lvgl.h>
 #include <WiFi.h>
+#include <esp_heap_caps.h>
 
 #include "data_model.h"
+#include "art_tiles.h"
+#include "artwork_cache.h"
 #include "ui.h"
 
 // Transport mode: "serial", "wifi", or "both"
@@ -38,22 +41,100 @@ SPIClass touchscreenSPI(VSPI);
 XPT2046_Touchscreen touchscreen(XPT2046_CS, XPT2046_IRQ);
 TFT_eSPI tft = TFT_eSPI();
 
-// LVGL 9 display buffer - reduced size to save memory
-static lv_color_t draw_buf[SCREEN_WIDTH * 10];
+// LVGL 9 draw buffers: two DMA-capable strips, so LVGL renders into one while
+// the other is shifted out over SPI. Sized at startup from the free
+// DMA-capable heap, keeping DRAW_BUF_HEAP_RESERVE for WiFi, the ingest task and
+// LVGL objects; a single strip if only that fits (no overlap, still DMA),
+// and the static strip below if the heap has none to give.
+#define DRAW_BUF_MAX_LINES 40
+#define DRAW_BUF_MIN_LINES 10
+#define DRAW_BUF_HEAP_RESERVE (96 * 1024)
+#define DRAW_BUF_LINE_BYTES (SCREEN_WIDTH * sizeof(lv_color16_t))
 
-// LVGL 9 display flush callback
+// Last resort, so the display always has a buffer
+static DMA_ATTR lv_color16_t gFallbackDrawBuf[SCREEN_WIDTH * DRAW_BUF_MIN_LINES] __attribute__((aligned(4)));
+
+static bool gFlushDmaActive = false;   // Bus held by a DMA transfer not yet waited for
+
+// Flush statistics for the periodic log
+static uint32_t gFrames = 0;           // Refreshes that drew something
+static uint32_t gFlushWaitUs = 0;      // Time spent blocked on SPI
+
+// Finish the pending DMA transfer, if any, and release the bus
+static void flush_dma_finish() {
+    if (!gFlushDmaActive) return;
+    uint32_t t0 = micros();
+    tft.dmaWait();
+    gFlushWaitUs += micros() - t0;
+    tft.endWrite();
+    gFlushDmaActive = false;
+}
+
+// LVGL 9 display flush callback: start the transfer and return. LVGL keeps
+// rendering into the other buffer and calls my_disp_flush_wait before it
+// touches this one again.
 static void my_disp_flush(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
     uint32_t w = (area->x2 - area->x1 + 1);
     uint32_t h = (area->y2 - area->y1 + 1);
 
+    flush_dma_finish();
     tft.startWrite();
     tft.setAddrWindow(area->x1, area->y1, w, h);
-    tft.pushPixels((uint16_t *)px_map, w * h);
-    tft.endWrite();
+    tft.pushPixelsDMA((uint16_t *)px_map, w * h);
+    gFlushDmaActive = true;
+    if (lv_display_flush_is_last(disp)) gFrames++;
+}
 
+// TFT_eSPI has no DMA completion callback, so the flush is completed here,
+// when LVGL needs the buffer back
+static void my_disp_flush_wait(lv_display_t *disp) {
+    flush_dma_finish();
     lv_display_flush_ready(disp);
 }
 
+// Allocate the draw buffers and hand them to LVGL
+static void setup_draw_buffers(lv_display_t *disp) {
+    size_t avail = heap_caps_get_free_size(MALLOC_CAP_DMA);
+    size_t lines = avail > DRAW_BUF_HEAP_RESERVE
+                 ? (avail - DRAW_BUF_HEAP_RESERVE) / (2 * DRAW_BUF_LINE_BYTES) : 0;
+    size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_DMA) / DRAW_BUF_LINE_BYTES;
+    if (lines > largest) lines = largest;
+    if (lines > DRAW_BUF_MAX_LINES) lines = DRAW_BUF_MAX_LINES;
+    if (lines < DRAW_BUF_MIN_LINES) lines = DRAW_BUF_MIN_LINES;
+
+    size_t bytes = lines * DRAW_BUF_LINE_BYTES;
+    void *buf1 = heap_caps_malloc(bytes, MALLOC_CAP_DMA);
+    void *buf2 = heap_caps_malloc(bytes, MALLOC_CAP_DMA);
+    if (!buf1 || !buf2) {
+        // Not enough for two: one minimum strip
+        heap_caps_free(buf1);
+        heap_caps_free(buf2);
+        buf2 = nullptr;
+        bytes = DRAW_BUF_MIN_LINES * DRAW_BUF_LINE_BYTES;
+        buf1 = heap_caps_malloc(bytes, MALLOC_CAP_DMA);
+    }
+    if (!buf1) {
+        Serial.println("[DISPLAY] WARNING: No heap for a draw buffer, using the static one");
+        buf1 = gFallbackDrawBuf;
+        bytes = sizeof(gFallbackDrawBuf);
+    }
+    lv_display_set_buffers(disp, buf1, buf2, bytes, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    Serial.printf("[DISPLAY] Draw buffers: %u x %u lines\n", buf2 ? 2 : 1, (unsigned)(bytes / DRAW_BUF_LINE_BYTES));
+}
+
+// Ambient artwork tiles bypass LVGL and go straight to the panel (see art_tiles.cpp)
+static void ambient_blit(int x, int y, int w, int h, const uint16_t *px) {
+    flush_dma_finish();
+    tft.startWrite();
+    if (px) {
+        tft.setAddrWindow(x, y, w, h);
+        tft.pushPixels(px, w * h);
+    } else {
+        tft.fillRect(x, y, w, h, TFT_BLACK);
+    }
+    tft.endWrite();
+}
+
 // LVGL 9 touch read callback
 static void my_touchpad_read(lv_indev_t *indev, lv_indev_data_t *data) {
     if (touchscreen.tirqTouched() && touchscreen.touched()) {
@@ -80,6 +161,7 @@ void setup() {
     tft.setSwapBytes(true);   // Important for correct colors with LVGL
     tft.invertDisplay(false); // Keep colors not inverted
     tft.fillScreen(TFT_BLACK);
+    tft.initDMA();
 
     // Initialize touch
     touchscreenSPI.begin(XPT2046_CLK, XPT2046_MISO, XPT2046_MOSI, XPT2046_CS);
@@ -92,7 +174,8 @@ void setup() {
     // Create display (LVGL 9 API)
     lv_display_t *disp = lv_display_create(SCREEN_WIDTH, SCREEN_HEIGHT);
     lv_display_set_flush_cb(disp, my_disp_flush);
-    lv_display_set_buffers(disp, draw_buf, NULL, sizeof(draw_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_wait_cb(disp, my_disp_flush_wait);
+    setup_draw_buffers(disp);
 
     // Create touch input device (LVGL 9 API)
     lv_indev_t *indev = lv_indev_create();
@@ -101,6 +184,8 @@ void setup() {
 
     // Initialize data model and UI
     data_model_init();
+    art_tiles_init();
+    artwork_cache_init();
     ui_init();
 
 #if USE_WIFI_TRANSPORT
@@ -128,19 +213,28 @@ static size_t minHeapSeen = 999999;
 
 void loop() {
     lv_tick_inc(5);
+    // Events from the ingest task land before rendering, in this frame
+    ui_drain_events();
     lv_timer_handler();
     
     // Smooth progress bar interpolation (call frequently)
     ui_tick();
+
+    // Draw ambient artwork tiles after LVGL so nothing paints over them this frame
+    art_tiles_service(ambient_blit, 4);
     
     // Periodic heap monitoring (every 30 seconds)
     uint32_t now = millis();
     if (now - lastHeapLog > 30000) {
+        uint32_t elapsed = now - lastHeapLog;
         lastHeapLog = now;
         size_t freeHeap = ESP.getFreeHeap();
         size_t minFree = ESP.getMinFreeHeap();
         if (freeHeap < minHeapSeen) minHeapSeen = freeHeap;
         Serial.printf("[HEAP] Free: %d, Min: %d, Session Min: %d\n", freeHeap, minFree, minHeapSeen);
+        Serial.printf("[DISPLAY] %.1f fps, %u ms blocked on SPI\n", gFrames * 1000.0f / elapsed, gFlushWaitUs / 1000);
+        gFrames = 0;
+        gFlushWaitUs = 0;
         
         // Warn if heap is getting low
         if (freeHeap < 30000) {
@@ -148,71 +242,90 @@ void loop() {
         }
     }
 
-    SnapshotMsg msg;
-    if (data_model_try_dequeue(msg)) {
-        SystemData sys;
-        MediaData med;
+    // UI model, kept between snapshots: only the domains that changed are
+    // copied. Acks were applied before rendering (ui_drain_events); next come
+    // structural changes in arrival order, then the newest telemetry.
+    static SystemData sys;
+    static MediaData med;
+    static ModelGens modelGens = {};   // Generations of what sys/med hold
+    bool modelChanged = false;
 
-        sys.cpu = msg.cpu;
-        sys.mem = msg.mem;
-        sys.gpu = msg.gpu;
-        sys.procCount = msg.procCount;
-        sys.valid = true;
-        
-        for (uint8_t i = 0; i < msg.procCount && i < 5; ++i) {
-            sys.procs[i] = String(msg.procs[i]);
+    while (const StructuralMsg *st = data_model_take_structural()) {
+        if (st->domains & DOMAIN_BIT(DOMAIN_QUEUE)) {
+            med.hasQueue = st->hasQueue;
+            med.queueLen = st->queueLen;
+            for (uint8_t i = 0; i < st->queueLen && i < MAX_QUEUE_ITEMS; ++i) {
+                med.queue[i] = st->queue[i];
+            }
+            modelGens.gen[DOMAIN_QUEUE] = st->gens.gen[DOMAIN_QUEUE];
+        }
+        if (st->domains & DOMAIN_BIT(DOMAIN_PLAYLIST)) {
+            med.hasPlaylist = st->hasPlaylist;
+            if (st->hasPlaylist) {
+                med.playlist = st->playlist;
+            }
+            modelGens.gen[DOMAIN_PLAYLIST] = st->gens.gen[DOMAIN_PLAYLIST];
+        }
+        modelChanged = true;
+    }
+
+    const SnapshotMsg* snap = data_model_take_latest();
+    if (snap) {
+        const SnapshotMsg &msg = *snap;
+
+        static ModelGens copied = {};
+        uint8_t dirty = model_take_dirty(msg.gens, copied);
+
+        if (dirty & DOMAIN_BIT(DOMAIN_SYSTEM)) {
+            sys.cpu = msg.cpu;
+            sys.mem = msg.mem;
+            sys.gpu = msg.gpu;
+            sys.procCount = msg.procCount;
+            sys.valid = true;
+            
+            for (uint8_t i = 0; i < msg.procCount && i < 5; ++i) {
+                sys.procHash[i] = model_copy_str(sys.procs[i], sizeof(sys.procs[i]), snapshot_str(msg, msg.procs[i]));
                 sys.procPids[i] = msg.procPids[i];
+            }
         }
 
-        if (msg.hasMedia) {
-            med.title = String(msg.title);
-            med.artist = String(msg.artist);
-            med.album = String(msg.album);
-            med.source = String(msg.source);
-            med.trackUri = String(msg.trackUri);
+        // Without media the parser leaves every media field cleared
+        if (dirty & DOMAIN_BIT(DOMAIN_PLAYBACK)) {
+            model_copy_str(med.title, sizeof(med.title), snapshot_str(msg, msg.title));
+            model_copy_str(med.artist, sizeof(med.artist), snapshot_str(msg, msg.artist));
+            model_copy_str(med.album, sizeof(med.album), snapshot_str(msg, msg.album));
+            model_copy_str(med.source, sizeof(med.source), snapshot_str(msg, msg.source));
+            model_copy_str(med.trackUri, sizeof(med.trackUri), snapshot_str(msg, msg.trackUri));
             med.position = msg.position;
             med.duration = msg.duration;
             med.isPlaying = msg.isPlaying;
             med.shuffle = msg.shuffle;
             med.repeat = msg.repeat;
             med.isLiked = msg.isLiked;
-            med.valid = true;
-            
-            // Artwork is decoded directly into global buffer by data_model
-            med.hasArtwork = msg.hasArtwork;
-            med.artworkUpdated = msg.artworkUpdated;
-            
-            // Copy queue data
-            med.hasQueue = msg.hasQueue;
-            med.queueLen = msg.queueLen;
-            for (uint8_t i = 0; i < msg.queueLen && i < MAX_QUEUE_ITEMS; ++i) {
-                med.queue[i] = msg.queue[i];
-            }
-            
-            // Copy playlist context
-            med.hasPlaylist = msg.hasPlaylist;
-            if (msg.hasPlaylist) {
-                med.playlist = msg.playlist;
-            }
-        } else {
-            med.valid = false;
-            med.hasArtwork = false;
-            med.artworkUpdated = false;
-            med.hasQueue = false;
-            med.hasPlaylist = false;
-            med.shuffle = false;
-            med.repeat = 0;
-            med.isLiked = false;
+            med.valid = msg.hasMedia;
         }
-        
-        // Copy Discord voice call state (independent of media)
-        med.hasDiscord = msg.hasDiscord;
-        if (msg.hasDiscord) {
-            med.discord = msg.discord;
+
+        // Artwork is decoded directly into global buffer by data_model
+        med.hasArtwork = msg.hasArtwork;
+        med.artworkUpdated = msg.artworkUpdated;
+
+        // Discord voice call state (independent of media)
+        if (dirty & DOMAIN_BIT(DOMAIN_DISCORD)) {
+            med.hasDiscord = msg.hasDiscord;
+            if (msg.hasDiscord) {
+                med.discord = msg.discord;
+            }
         }
 
-        ui_update(sys, med);
+        // Queue and playlist come from the structural lane only
+        for (int d = 0; d < DOMAIN_COUNT; ++d) {
+            if (d != DOMAIN_QUEUE && d != DOMAIN_PLAYLIST) modelGens.gen[d] = msg.gens.gen[d];
+        }
+        modelChanged = true;
     }
 
+    // Applied by the UI's frame timer within UPDATE_INTERVAL_MS, never dropped
+    if (modelChanged) ui_update(sys, med, modelGens);
+
     delay(5);
 }
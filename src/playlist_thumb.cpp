@@ -0,0 +1,176 @@
+/**
+ * @file playlist_thumb.cpp
+ * Playlist cover thumbnail, decoded once per playlist snapshot
+ *
+ * Snapshots name the current playlist's snapshot_id on every update. The
+ * cover JPEG only needs to ride along until the device has decoded it for
+ * that snapshot: the ingest task decodes it (TJpgDec, scaled and cropped to
+ * PLAYLIST_THUMB_SIZE), answers "have", and ignores further copies. A new
+ * snapshot_id without an image gets a "need" instead, and so does a cover
+ * that failed to decode, up to PLAYLIST_THUMB_MAX_TRIES attempts.
+ *
+ * Same two-buffer handshake as artwork.cpp, at 1 KB per buffer: the ingest
+ * task only writes the back buffer and the UI swaps it to the front.
+ */
+
+#include "playlist_thumb.h"
+#include "base64_fast.h"
+#include "data_model.h"
+#include <TJpg_Decoder.h>
+#include <atomic>
+
+#define PLAYLIST_THUMB_JPEG_MAX_SIZE 4096
+#define PLAYLIST_THUMB_REPLY_MS 10000   // Repeat have/need at most this often
+#define PLAYLIST_THUMB_MAX_TRIES 3      // Decode attempts per snapshot before giving up
+
+enum ThumbState : uint8_t { THUMB_FREE, THUMB_WRITING, THUMB_READY, THUMB_CONSUMING };
+
+struct PlaylistThumb {
+    uint16_t px[PLAYLIST_THUMB_SIZE * PLAYLIST_THUMB_SIZE];
+    uint16_t w, h;
+    char snapshotId[sizeof(PlaylistInfo::snapshotId)];
+};
+
+static PlaylistThumb gThumb[2];
+static std::atomic<uint8_t> gFront{0};          // Written by the UI only
+static std::atomic<uint8_t> gBackState{THUMB_FREE};
+
+// Ingest-task state
+static PlaylistThumb* gBack = nullptr;
+static char gDoneId[sizeof(PlaylistInfo::snapshotId)];      // Snapshot whose cover was handled
+static char gRepliedId[sizeof(PlaylistInfo::snapshotId)];
+static uint32_t gRepliedMs = 0;
+static char gFailedId[sizeof(PlaylistInfo::snapshotId)];    // Snapshot whose cover failed to decode
+static uint8_t gFailures = 0;
+static int gCropX = 0, gCropY = 0;
+
+static void begin_write() {
+    uint8_t s = gBackState.load();
+    for (;;) {
+        if (s == THUMB_CONSUMING) {
+            s = gBackState.load();
+            continue;
+        }
+        if (gBackState.compare_exchange_weak(s, THUMB_WRITING)) break;
+    }
+    gBack = &gThumb[1 - gFront.load()];
+}
+
+// TJpgDec output: one MCU block, shifted by the crop offset and clipped
+static bool thumb_block_cb(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t* bitmap) {
+    int bx = x - gCropX, by = y - gCropY;
+    int x0 = bx < 0 ? -bx : 0;
+    int x1 = (bx + w > gBack->w) ? gBack->w - bx : w;
+    if (x1 <= x0) return true;
+
+    for (int row = 0; row < h; ++row) {
+        int dy = by + row;
+        if (dy < 0 || dy >= gBack->h) continue;
+        memcpy(&gBack->px[dy * gBack->w + bx + x0], &bitmap[row * w + x0], (x1 - x0) * 2);
+    }
+    return true;
+}
+
+static bool decode_jpeg_b64(const char* snapshotId, const char* b64, size_t b64Len) {
+    size_t jpgLen = b64_decoded_len(b64, b64Len);
+    if (jpgLen == 0 || jpgLen > PLAYLIST_THUMB_JPEG_MAX_SIZE) {
+        Serial.printf("[PLAYLIST] Cover size %d out of range\n", jpgLen);
+        return false;
+    }
+    uint8_t* jpg = (uint8_t*)malloc(jpgLen);
+    if (!jpg) {
+        Serial.printf("[PLAYLIST] No memory for %d byte cover\n", jpgLen);
+        return false;
+    }
+
+    bool ok = false;
+    uint16_t w = 0, hgt = 0;
+    if (!b64_decode_fast(b64, b64Len, jpg, jpgLen, &jpgLen) ||
+        TJpgDec.getJpgSize(&w, &hgt, jpg, jpgLen) != JDR_OK || w == 0 || hgt == 0) {
+        Serial.println("[PLAYLIST] Cover is not a JPEG");
+    } else {
+        // Reduce while the short edge still covers the thumbnail, then crop the middle
+        uint8_t scale = 1;
+        while (scale < 8 && (w < hgt ? w : hgt) / (scale * 2) >= PLAYLIST_THUMB_SIZE) scale <<= 1;
+        int outW = w / scale, outH = hgt / scale;
+
+        begin_write();
+        gBack->w = outW < PLAYLIST_THUMB_SIZE ? outW : PLAYLIST_THUMB_SIZE;
+        gBack->h = outH < PLAYLIST_THUMB_SIZE ? outH : PLAYLIST_THUMB_SIZE;
+        gCropX = (outW - gBack->w) / 2;
+        gCropY = (outH - gBack->h) / 2;
+
+        TJpgDec.setJpgScale(scale);
+        TJpgDec.setSwapBytes(false);  // LVGL wants native-endian RGB565
+        TJpgDec.setCallback(thumb_block_cb);
+        JRESULT jr = TJpgDec.drawJpg(0, 0, jpg, jpgLen);
+        ok = (jr == JDR_OK);
+        if (ok) {
+            strncpy(gBack->snapshotId, snapshotId, sizeof(gBack->snapshotId) - 1);
+            gBack->snapshotId[sizeof(gBack->snapshotId) - 1] = '\0';
+            gBackState.store(THUMB_READY);
+            Serial.printf("[PLAYLIST] Cover %dx%d (1/%d) -> %dx%d\n", w, hgt, scale, gBack->w, gBack->h);
+        } else {
+            Serial.printf("[PLAYLIST] Cover decode failed: jr=%d\n", jr);
+            gBackState.store(THUMB_FREE);
+        }
+    }
+    free(jpg);
+    return ok;
+}
+
+static void reply(const char* what, const char* snapshotId) {
+    uint32_t now = millis();
+    if (strcmp(gRepliedId, snapshotId) == 0 && now - gRepliedMs < PLAYLIST_THUMB_REPLY_MS) return;
+    char msg[128];
+    snprintf(msg, sizeof(msg), "{\"cmd\":\"playlist_thumb_%s\",\"key\":\"%s\"}", what, snapshotId);
+    send_reply(msg);
+    strcpy(gRepliedId, snapshotId);
+    gRepliedMs = now;
+}
+
+void playlist_thumb_note(const char* snapshotId, const char* b64, size_t b64Len) {
+    if (!snapshotId[0] || strlen(snapshotId) >= sizeof(gDoneId)) return;
+
+    if (strcmp(snapshotId, gDoneId) == 0) {
+        if (b64Len > 0) reply("have", snapshotId);   // Server missed the first answer
+        return;
+    }
+    if (b64Len == 0) {
+        reply("need", snapshotId);
+        return;
+    }
+
+    if (strcmp(snapshotId, gFailedId) != 0) {
+        strcpy(gFailedId, snapshotId);
+        gFailures = 0;
+    }
+    if (!decode_jpeg_b64(snapshotId, b64, b64Len) && ++gFailures < PLAYLIST_THUMB_MAX_TRIES) {
+        // Possibly transient (e.g. no memory): try the next copy
+        reply("need", snapshotId);
+        return;
+    }
+    if (gFailures >= PLAYLIST_THUMB_MAX_TRIES) {
+        Serial.printf("[PLAYLIST] Giving up on the cover of %s\n", snapshotId);
+    }
+    // Decoded, or not worth resending any more
+    strcpy(gDoneId, snapshotId);
+    gFailedId[0] = '\0';
+    gRepliedId[0] = '\0';
+    reply("have", snapshotId);
+}
+
+// UI side: swap a published cover to the front
+const uint8_t* playlist_thumb_take_new(uint16_t* w, uint16_t* h, const char** snapshotId) {
+    uint8_t expected = THUMB_READY;
+    if (!gBackState.compare_exchange_strong(expected, THUMB_CONSUMING)) return nullptr;
+    uint8_t front = 1 - gFront.load();
+    gFront.store(front);
+    gBackState.store(THUMB_FREE);
+
+    const PlaylistThumb& t = gThumb[front];
+    *w = t.w;
+    *h = t.h;
+    *snapshotId = t.snapshotId;
+    return (const uint8_t*)t.px;
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <Arduino.h>
+
+// Playlist cover shown next to the playlist name on the queue page
+#define PLAYLIST_THUMB_SIZE 24      // Largest edge; bigger covers are scaled, then center-cropped
+
+// --- Ingest side ---
+// Called with every snapshot's playlist. The base64 JPEG (may be empty) is
+// decoded once per snapshotId (retried a few times if decoding fails); the device answers
+// {"cmd":"playlist_thumb_have"|"playlist_thumb_need","key":"<snapshotId>"}
+// so the server can stop sending the image.
+void playlist_thumb_note(const char* snapshotId, const char* b64, size_t b64Len);
+
+// --- UI side ---
+// Newly decoded cover (native RGB565, w x h), or nullptr. *snapshotId is the
+// playlist snapshot it belongs to; both stay valid until the next call.
+const uint8_t* playlist_thumb_take_new(uint16_t* w, uint16_t* h, const char** snapshotId);
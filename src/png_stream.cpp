@@ -0,0 +1,477 @@
+/**
+ * @file png_stream.cpp
+ * Streaming PNG decoder for artwork payloads
+ *
+ * IDAT data is inflated byte by byte into a circular window sized from the
+ * zlib header (capped at the inflated image size, so an 80x80 RGB PNG needs
+ * under 20 KB instead of the usual 32 KB). Every inflated byte also lands in
+ * the current scanline; once a line is complete it is unfiltered against the
+ * previous one, converted to RGB565 and handed to the caller. No full-image
+ * intermediate is ever allocated.
+ */
+
+#include "png_stream.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const uint8_t kPngSig[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+// Deflate length/distance tables (RFC 1951 3.2.5)
+static const uint16_t kLenBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t kLenExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t kDistBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t kDistExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+static const uint8_t kCodeLenOrder[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+// Canonical Huffman code: number of codes per bit length + symbols in code order
+struct Huff {
+    uint16_t counts[16];
+    uint16_t symbols[288];
+};
+
+struct PngDec {
+    // IDAT walker (the zlib stream may be split over several chunks)
+    const uint8_t* png;
+    size_t len;
+    size_t pos;
+    size_t chunkLeft;
+    uint32_t bitBuf;
+    int bitCnt;
+    bool eof;
+
+    // Inflate window
+    uint8_t* window;
+    uint32_t winSize;
+    uint32_t winPos;
+    uint32_t total;
+    uint32_t adlerA, adlerB;
+
+    // Scanlines
+    int width, height, y;
+    uint8_t colorType, depth, channels;
+    int bpp;            // Filter distance in bytes (at least 1)
+    size_t rowBytes;    // Without the filter-type byte
+    size_t rowFill;
+    uint8_t* cur;       // cur[0] is the filter type
+    uint8_t* prev;
+    uint16_t* out;
+    bool rowError;
+    uint16_t palette[256];
+    png_row_cb cb;
+    void* user;
+
+    Huff lit, dist;
+};
+
+static uint32_t be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b) {
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+static inline uint8_t blend(uint8_t v, uint8_t a) {
+    return (uint8_t)((v * a + 127) / 255);  // Over black
+}
+
+// Next zlib byte, hopping to the following IDAT when a chunk runs out
+static int next_byte(PngDec& d) {
+    while (d.chunkLeft == 0) {
+        d.pos += 4;  // CRC of the finished chunk
+        if (d.pos + 8 > d.len || memcmp(d.png + d.pos + 4, "IDAT", 4) != 0) return -1;
+        uint32_t clen = be32(d.png + d.pos);
+        d.pos += 8;
+        if (clen > d.len - d.pos) return -1;
+        d.chunkLeft = clen;
+    }
+    d.chunkLeft--;
+    return d.png[d.pos++];
+}
+
+static uint32_t get_bits(PngDec& d, int n) {
+    while (d.bitCnt < n) {
+        int b = next_byte(d);
+        if (b < 0) {
+            d.eof = true;
+            b = 0;
+        }
+        d.bitBuf |= (uint32_t)b << d.bitCnt;
+        d.bitCnt += 8;
+    }
+    uint32_t v = d.bitBuf & ((1u << n) - 1);
+    d.bitBuf >>= n;
+    d.bitCnt -= n;
+    return v;
+}
+
+static bool huff_build(Huff& t, const uint8_t* lengths, int num) {
+    uint16_t offs[16];
+    memset(t.counts, 0, sizeof(t.counts));
+    for (int i = 0; i < num; ++i) t.counts[lengths[i]]++;
+    t.counts[0] = 0;
+
+    // Over-subscribed sets are corrupt; incomplete ones are legal (e.g. one distance code)
+    int left = 1;
+    for (int i = 1; i < 16; ++i) {
+        left = (left << 1) - t.counts[i];
+        if (left < 0) return false;
+    }
+
+    offs[1] = 0;
+    for (int i = 1; i < 15; ++i) offs[i + 1] = offs[i] + t.counts[i];
+    for (int i = 0; i < num; ++i) {
+        if (lengths[i]) t.symbols[offs[lengths[i]]++] = i;
+    }
+    return true;
+}
+
+static int huff_decode(PngDec& d, const Huff& t) {
+    int code = 0, first = 0, index = 0;
+    for (int len = 1; len < 16; ++len) {
+        code |= get_bits(d, 1);
+        int count = t.counts[len];
+        if (code - first < count) return t.symbols[index + code - first];
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+// Scanline complete: unfilter against the previous line, convert, deliver
+static void finish_row(PngDec& d) {
+    uint8_t* r = d.cur + 1;
+    const uint8_t* p = d.prev + 1;
+    size_t n = d.rowBytes;
+    int bpp = d.bpp;
+
+    switch (d.cur[0]) {
+    case 0:
+        break;
+    case 1:
+        for (size_t i = bpp; i < n; ++i) r[i] += r[i - bpp];
+        break;
+    case 2:
+        for (size_t i = 0; i < n; ++i) r[i] += p[i];
+        break;
+    case 3:
+        for (size_t i = 0; i < n; ++i) r[i] += ((i >= (size_t)bpp ? r[i - bpp] : 0) + p[i]) >> 1;
+        break;
+    case 4:
+        for (size_t i = 0; i < n; ++i) {
+            int a = i >= (size_t)bpp ? r[i - bpp] : 0;
+            int b = p[i];
+            int c = i >= (size_t)bpp ? p[i - bpp] : 0;
+            int pa = abs(b - c), pb = abs(a - c), pc = abs(a + b - 2 * c);
+            r[i] += (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+        }
+        break;
+    default:
+        d.rowError = true;
+        return;
+    }
+
+    for (int x = 0; x < d.width; ++x) {
+        uint16_t px;
+        if (d.depth < 8) {
+            int bit = x * d.depth;
+            int mask = (1 << d.depth) - 1;
+            int v = (r[bit >> 3] >> (8 - d.depth - (bit & 7))) & mask;
+            if (d.colorType == 3) {
+                px = d.palette[v];
+            } else {
+                uint8_t g = (uint8_t)(v * 255 / mask);
+                px = rgb565(g, g, g);
+            }
+        } else {
+            // 16-bit samples are big-endian; only the high byte matters for RGB565
+            int step = d.depth >> 3;
+            const uint8_t* s = r + x * d.channels * step;
+            switch (d.colorType) {
+            case 0:
+                px = rgb565(s[0], s[0], s[0]);
+                break;
+            case 2:
+                px = rgb565(s[0], s[step], s[2 * step]);
+                break;
+            case 3:
+                px = d.palette[s[0]];
+                break;
+            case 4: {
+                uint8_t g = blend(s[0], s[step]);
+                px = rgb565(g, g, g);
+                break;
+            }
+            default: {
+                uint8_t a = s[3 * step];
+                px = rgb565(blend(s[0], a), blend(s[step], a), blend(s[2 * step], a));
+                break;
+            }
+            }
+        }
+        d.out[x] = px;
+    }
+    d.cb(d.y, d.out, d.width, d.user);
+
+    uint8_t* t = d.prev;
+    d.prev = d.cur;
+    d.cur = t;
+    d.rowFill = 0;
+    d.y++;
+}
+
+static void put_byte(PngDec& d, uint8_t b) {
+    d.window[d.winPos] = b;
+    if (++d.winPos == d.winSize) d.winPos = 0;
+    d.total++;
+
+    d.adlerA += b;
+    if (d.adlerA >= 65521) d.adlerA -= 65521;
+    d.adlerB += d.adlerA;
+    if (d.adlerB >= 65521) d.adlerB -= 65521;
+
+    if (d.rowError) return;
+    if (d.y >= d.height) {
+        d.rowError = true;  // More data than the image holds
+        return;
+    }
+    d.cur[d.rowFill++] = b;
+    if (d.rowFill == d.rowBytes + 1) finish_row(d);
+}
+
+static bool inflate_stored(PngDec& d) {
+    d.bitBuf >>= d.bitCnt & 7;
+    d.bitCnt -= d.bitCnt & 7;
+    uint32_t len = get_bits(d, 16);
+    uint32_t nlen = get_bits(d, 16);
+    if ((len ^ 0xFFFF) != nlen) return false;
+    while (len--) {
+        put_byte(d, (uint8_t)get_bits(d, 8));
+        if (d.eof || d.rowError) return false;
+    }
+    return true;
+}
+
+static bool inflate_codes(PngDec& d) {
+    for (;;) {
+        int sym = huff_decode(d, d.lit);
+        if (sym < 0) return false;
+        if (sym < 256) {
+            put_byte(d, (uint8_t)sym);
+        } else if (sym == 256) {
+            return true;
+        } else {
+            sym -= 257;
+            if (sym >= 29) return false;
+            uint32_t len = kLenBase[sym] + get_bits(d, kLenExtra[sym]);
+            int ds = huff_decode(d, d.dist);
+            if (ds < 0 || ds >= 30) return false;
+            uint32_t dist = kDistBase[ds] + get_bits(d, kDistExtra[ds]);
+            if (dist > d.total || dist > d.winSize) return false;
+
+            uint32_t from = d.winPos >= dist ? d.winPos - dist : d.winPos + d.winSize - dist;
+            while (len--) {
+                uint8_t b = d.window[from];
+                if (++from == d.winSize) from = 0;
+                put_byte(d, b);
+            }
+        }
+        if (d.eof || d.rowError) return false;
+    }
+}
+
+static bool inflate_fixed(PngDec& d) {
+    uint8_t lengths[288];
+    memset(lengths, 8, 144);
+    memset(lengths + 144, 9, 112);
+    memset(lengths + 256, 7, 24);
+    memset(lengths + 280, 8, 8);
+    huff_build(d.lit, lengths, 288);
+    memset(lengths, 5, 30);
+    huff_build(d.dist, lengths, 30);
+    return inflate_codes(d);
+}
+
+static bool inflate_dynamic(PngDec& d) {
+    uint8_t lengths[286 + 30];
+    int hlit = get_bits(d, 5) + 257;
+    int hdist = get_bits(d, 5) + 1;
+    int hclen = get_bits(d, 4) + 4;
+    if (hlit > 286 || hdist > 30) return false;
+
+    // Code-length code, built into the literal table temporarily
+    memset(lengths, 0, 19);
+    for (int i = 0; i < hclen; ++i) lengths[kCodeLenOrder[i]] = get_bits(d, 3);
+    if (!huff_build(d.lit, lengths, 19)) return false;
+
+    for (int n = 0; n < hlit + hdist;) {
+        int sym = huff_decode(d, d.lit);
+        if (sym < 0 || d.eof) return false;
+        if (sym < 16) {
+            lengths[n++] = sym;
+            continue;
+        }
+        int rep;
+        uint8_t val = 0;
+        if (sym == 16) {
+            if (n == 0) return false;
+            val = lengths[n - 1];
+            rep = 3 + get_bits(d, 2);
+        } else if (sym == 17) {
+            rep = 3 + get_bits(d, 3);
+        } else {
+            rep = 11 + get_bits(d, 7);
+        }
+        if (n + rep > hlit + hdist) return false;
+        while (rep--) lengths[n++] = val;
+    }
+
+    if (lengths[256] == 0) return false;  // No end-of-block code
+    if (!huff_build(d.lit, lengths, hlit)) return false;
+    if (!huff_build(d.dist, lengths + hlit, hdist)) return false;
+    return inflate_codes(d);
+}
+
+static bool inflate_zlib(PngDec& d, uint32_t rawTotal) {
+    uint32_t cmf = get_bits(d, 8);
+    uint32_t flg = get_bits(d, 8);
+    if (d.eof || (cmf & 0x0F) != 8 || (cmf >> 4) > 7 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20)) {
+        return false;
+    }
+
+    // Back-references never reach past the declared window or the start of the image
+    d.winSize = 1u << ((cmf >> 4) + 8);
+    if (d.winSize > rawTotal) d.winSize = rawTotal;
+    d.window = (uint8_t*)malloc(d.winSize);
+    if (!d.window) return false;
+
+    uint32_t final;
+    do {
+        final = get_bits(d, 1);
+        uint32_t type = get_bits(d, 2);
+        bool ok;
+        if (type == 0) ok = inflate_stored(d);
+        else if (type == 1) ok = inflate_fixed(d);
+        else if (type == 2) ok = inflate_dynamic(d);
+        else ok = false;
+        if (!ok || d.eof || d.rowError) return false;
+    } while (!final);
+
+    // Adler-32 of the inflated data, big-endian after byte alignment
+    d.bitBuf >>= d.bitCnt & 7;
+    d.bitCnt -= d.bitCnt & 7;
+    uint32_t adler = 0;
+    for (int i = 0; i < 4; ++i) adler = (adler << 8) | get_bits(d, 8);
+    if (d.eof || adler != ((d.adlerB << 16) | d.adlerA)) return false;
+    return d.y == d.height;
+}
+
+bool png_get_size(const uint8_t* png, size_t len, uint16_t* w, uint16_t* h) {
+    if (len < 33 || memcmp(png, kPngSig, 8) != 0 || memcmp(png + 12, "IHDR", 4) != 0) return false;
+    uint32_t pw = be32(png + 16), ph = be32(png + 20);
+    if (pw == 0 || ph == 0 || pw > 0xFFFF || ph > 0xFFFF) return false;
+    *w = (uint16_t)pw;
+    *h = (uint16_t)ph;
+    return true;
+}
+
+bool png_decode_rows(const uint8_t* png, size_t len, png_row_cb cb, void* user) {
+    uint16_t w, h;
+    if (!png_get_size(png, len, &w, &h) || w > PNG_MAX_DIM || h > PNG_MAX_DIM) return false;
+    uint8_t depth = png[24], colorType = png[25];
+    if (png[26] != 0 || png[27] != 0 || png[28] != 0) return false;  // Deflate, filter 0, no interlace
+
+    uint8_t channels;
+    bool depthOk;
+    switch (colorType) {
+    case 0: channels = 1; depthOk = depth == 1 || depth == 2 || depth == 4 || depth == 8 || depth == 16; break;
+    case 2: channels = 3; depthOk = depth == 8 || depth == 16; break;
+    case 3: channels = 1; depthOk = depth == 1 || depth == 2 || depth == 4 || depth == 8; break;
+    case 4: channels = 2; depthOk = depth == 8 || depth == 16; break;
+    case 6: channels = 4; depthOk = depth == 8 || depth == 16; break;
+    default: return false;
+    }
+    if (!depthOk) return false;
+
+    // Walk ancillary chunks up to the first IDAT
+    const uint8_t* plte = nullptr;
+    const uint8_t* trns = nullptr;
+    uint32_t plteLen = 0, trnsLen = 0;
+    size_t pos = 8;
+    uint32_t clen = 0;
+    for (;;) {
+        if (pos + 8 > len) return false;
+        clen = be32(png + pos);
+        if (clen > len - pos - 8) return false;
+        const uint8_t* type = png + pos + 4;
+        if (memcmp(type, "IDAT", 4) == 0) break;
+        if (memcmp(type, "IEND", 4) == 0) return false;
+        if (memcmp(type, "PLTE", 4) == 0) {
+            plte = png + pos + 8;
+            plteLen = clen;
+        } else if (memcmp(type, "tRNS", 4) == 0) {
+            trns = png + pos + 8;
+            trnsLen = clen;
+        }
+        pos += 12 + clen;
+    }
+    if (colorType == 3 && !plte) return false;
+
+    PngDec* d = (PngDec*)calloc(1, sizeof(PngDec));
+    if (!d) return false;
+    d->png = png;
+    d->len = len;
+    d->pos = pos + 8;
+    d->chunkLeft = clen;
+    d->adlerA = 1;
+    d->width = w;
+    d->height = h;
+    d->colorType = colorType;
+    d->depth = depth;
+    d->channels = channels;
+    uint32_t bitsPerPixel = channels * depth;
+    d->rowBytes = (w * bitsPerPixel + 7) / 8;
+    d->bpp = bitsPerPixel >= 8 ? bitsPerPixel / 8 : 1;
+    d->cb = cb;
+    d->user = user;
+
+    if (colorType == 3) {
+        for (uint32_t i = 0; i < 256 && i * 3 + 2 < plteLen; ++i) {
+            const uint8_t* c = plte + i * 3;
+            uint8_t a = (trns && i < trnsLen) ? trns[i] : 255;
+            d->palette[i] = rgb565(blend(c[0], a), blend(c[1], a), blend(c[2], a));
+        }
+    }
+
+    // prev starts zeroed: the first line filters against an all-zero line
+    d->cur = (uint8_t*)malloc(d->rowBytes + 1);
+    d->prev = (uint8_t*)calloc(1, d->rowBytes + 1);
+    d->out = (uint16_t*)malloc(w * sizeof(uint16_t));
+
+    bool ok = false;
+    if (d->cur && d->prev && d->out) {
+        ok = inflate_zlib(*d, (uint32_t)h * (d->rowBytes + 1));
+    }
+
+    free(d->window);
+    free(d->cur);
+    free(d->prev);
+    free(d->out);
+    free(d);
+    return ok;
+}
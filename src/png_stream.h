@@ -0,0 +1,20 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Largest PNG width/height accepted (bounds the row buffers)
+#define PNG_MAX_DIM 320
+
+// Called once per decoded row with native-endian RGB565 pixels.
+// Alpha (palette tRNS or an alpha channel) is composited over black.
+typedef void (*png_row_cb)(int y, const uint16_t* rgb565, int width, void* user);
+
+// Read width/height from the IHDR chunk. False if this is not a PNG.
+bool png_get_size(const uint8_t* png, size_t len, uint16_t* w, uint16_t* h);
+
+// Decode a non-interlaced PNG (gray/RGB/palette/with alpha, 1-16 bit) from memory.
+// IDAT data is inflated through a circular window no larger than the one the
+// zlib header declares (and never larger than the image itself); each row is
+// unfiltered and converted as soon as it completes. Returns false on
+// unsupported or corrupt input (rows already delivered stay delivered).
+bool png_decode_rows(const uint8_t* png, size_t len, png_row_cb cb, void* user);
@@ -0,0 +1,163 @@
+/**
+ * @file queue_thumbs.cpp
+ * Thumbnail atlas for the Up Next list
+ *
+ * All queue thumbnails live in one static atlas of QUEUE_THUMB_SLOTS 32x32
+ * RGB565 slots, each tagged with the queue item ID it holds. When a snapshot
+ * brings a queue, the ingest task asks the server only for the items that
+ * have no slot yet, so advancing a track costs one 2 KB thumbnail instead
+ * of the whole list. The server answers with a single batched line.
+ *
+ * Slots are written by the ingest task and read by the UI. A slot that is
+ * being rewritten has an odd sequence number, and a new thumbnail never
+ * lands in a slot whose item is in the current queue, so pixels the UI
+ * handed to LVGL stay put while they are on screen.
+ */
+
+#include "queue_thumbs.h"
+#include "base64_fast.h"
+#include <atomic>
+
+#define QUEUE_THUMB_RETRY_MS 10000  // Re-ask if the server did not answer
+
+struct ThumbSlot {
+    char id[64];                    // QueueItem::id, "" = empty
+    std::atomic<uint32_t> seq{0};   // Odd while id/pixels are being rewritten
+    uint32_t lastUse;               // Ingest side only
+};
+
+static uint8_t gAtlas[QUEUE_THUMB_SLOTS][QUEUE_THUMB_BYTES] __attribute__((aligned(4)));
+static ThumbSlot gSlots[QUEUE_THUMB_SLOTS];
+static std::atomic<uint32_t> gGeneration{0};
+static uint32_t gUseTick = 0;
+
+// Last queue seen by the ingest task (protects its slots from eviction)
+static char gQueueIds[MAX_QUEUE_ITEMS][64];
+static uint8_t gQueueLen = 0;
+
+// Last need request, so an unchanged queue is not re-asked every snapshot
+static uint32_t gNeedHash = 0;
+static uint32_t gNeedMask = 0;
+static uint32_t gNeedMs = 0;
+
+static int find_slot(const char* id) {
+    for (int i = 0; i < QUEUE_THUMB_SLOTS; ++i) {
+        if (gSlots[i].id[0] && strcmp(gSlots[i].id, id) == 0) return i;
+    }
+    return -1;
+}
+
+static bool in_queue(const char* id) {
+    for (uint8_t i = 0; i < gQueueLen; ++i) {
+        if (strcmp(gQueueIds[i], id) == 0) return true;
+    }
+    return false;
+}
+
+// Empty slot first, then the least recently used one outside the current queue
+static int pick_victim() {
+    int best = -1;
+    for (int i = 0; i < QUEUE_THUMB_SLOTS; ++i) {
+        if (!gSlots[i].id[0]) return i;
+        if (in_queue(gSlots[i].id)) continue;
+        if (best < 0 || (int32_t)(gSlots[i].lastUse - gSlots[best].lastUse) < 0) best = i;
+    }
+    return best;
+}
+
+void queue_thumbs_note_queue(const char* const* ids, uint8_t count) {
+    if (count > MAX_QUEUE_ITEMS) count = MAX_QUEUE_ITEMS;
+
+    uint32_t hash = 2166136261u;    // FNV-1a over the IDs, in order
+    uint32_t mask = 0;
+    gUseTick++;
+    for (uint8_t i = 0; i < count; ++i) {
+        strncpy(gQueueIds[i], ids[i], sizeof(gQueueIds[i]) - 1);
+        gQueueIds[i][sizeof(gQueueIds[i]) - 1] = '\0';
+        for (const char* p = gQueueIds[i]; *p; ++p) hash = (hash ^ (uint8_t)*p) * 16777619u;
+        hash = (hash ^ 0xFF) * 16777619u;
+
+        if (!gQueueIds[i][0]) continue;
+        int s = find_slot(gQueueIds[i]);
+        if (s >= 0) {
+            gSlots[s].lastUse = gUseTick;
+        } else {
+            mask |= 1u << i;
+        }
+    }
+    gQueueLen = count;
+
+    uint32_t now = millis();
+    if (!mask) {
+        gNeedMask = 0;
+        return;
+    }
+    if (hash == gNeedHash && mask == gNeedMask && now - gNeedMs < QUEUE_THUMB_RETRY_MS) return;
+
+    // Indices into the queue just received: short enough for one command line
+    char reply[64];
+    int n = snprintf(reply, sizeof(reply), "{\"cmd\":\"queue_thumbs\",\"need\":[");
+    const char* sep = "";
+    for (uint8_t i = 0; i < count; ++i) {
+        if (!(mask & (1u << i))) continue;
+        n += snprintf(reply + n, sizeof(reply) - n, "%s%u", sep, i);
+        sep = ",";
+    }
+    snprintf(reply + n, sizeof(reply) - n, "]}");
+    send_reply(reply);
+
+    gNeedHash = hash;
+    gNeedMask = mask;
+    gNeedMs = now;
+}
+
+bool queue_thumbs_store(const char* id, const char* b64, size_t b64Len) {
+    size_t idLen = strlen(id);
+    if (idLen == 0 || idLen >= sizeof(gSlots[0].id)) return false;
+
+    int s = find_slot(id);
+    if (s >= 0) {
+        gSlots[s].lastUse = ++gUseTick;
+        return true;
+    }
+    s = pick_victim();
+    if (s < 0) {
+        Serial.println("[THUMB] No free slot");
+        return false;
+    }
+
+    ThumbSlot &slot = gSlots[s];
+    slot.seq.fetch_add(1, std::memory_order_acq_rel);   // Odd: readers skip it
+    size_t olen = 0;
+    bool ok = b64_decode_fast(b64, b64Len, gAtlas[s], QUEUE_THUMB_BYTES, &olen) && olen == QUEUE_THUMB_BYTES;
+    if (ok) {
+        memcpy(slot.id, id, idLen + 1);
+    } else {
+        slot.id[0] = '\0';
+        Serial.printf("[THUMB] Bad thumbnail for %s (%u bytes)\n", id, (unsigned)olen);
+    }
+    slot.lastUse = ++gUseTick;
+    slot.seq.fetch_add(1, std::memory_order_release);
+    if (ok) gGeneration.fetch_add(1, std::memory_order_release);
+    return ok;
+}
+
+uint32_t queue_thumbs_generation() {
+    return gGeneration.load(std::memory_order_acquire);
+}
+
+int queue_thumbs_find(const char* id) {
+    if (!id[0]) return -1;
+    for (int i = 0; i < QUEUE_THUMB_SLOTS; ++i) {
+        uint32_t s1 = gSlots[i].seq.load(std::memory_order_acquire);
+        if (s1 & 1) continue;
+        bool match = strcmp(gSlots[i].id, id) == 0;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (match && gSlots[i].seq.load(std::memory_order_relaxed) == s1) return i;
+    }
+    return -1;
+}
+
+const uint8_t* queue_thumbs_atlas() {
+    return gAtlas[0];
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <Arduino.h>
+#include "data_model.h"
+
+// Up Next thumbnails: one atlas of 32x32 RGB565 slots, keyed by queue item ID
+#define QUEUE_THUMB_SIZE 32
+#define QUEUE_THUMB_BYTES (QUEUE_THUMB_SIZE * QUEUE_THUMB_SIZE * 2)
+#define QUEUE_THUMB_SLOTS (MAX_QUEUE_ITEMS + 1)   // One spare so a shift never evicts a visible item
+
+// --- Ingest side ---
+// Called with the item IDs of every parsed queue: asks the server for the
+// thumbnails of items not in the atlas yet ({"cmd":"queue_thumbs","need":[...]})
+void queue_thumbs_note_queue(const char* const* ids, uint8_t count);
+// Store one base64 RGB565 thumbnail for item id. Already-held IDs are kept as-is.
+bool queue_thumbs_store(const char* id, const char* b64, size_t b64Len);
+
+// --- UI side ---
+// Bumped every time a slot gets new pixels
+uint32_t queue_thumbs_generation();
+// Atlas slot holding the thumbnail for item id, or -1
+int queue_thumbs_find(const char* id);
+// Start of the atlas: slot s is QUEUE_THUMB_BYTES of RGB565 at s * QUEUE_THUMB_BYTES
+const uint8_t* queue_thumbs_atlas();
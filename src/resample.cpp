@@ -0,0 +1,102 @@
+/**
+ * @file resample.cpp
+ * Streaming area-averaging resampler (RGB565, integer only)
+ *
+ * Source pixel i spans [i*dstW, (i+1)*dstW) and destination pixel j spans
+ * [j*srcW, (j+1)*srcW) on a common integer axis (same for rows), so every
+ * overlap is an exact integer weight and each destination pixel's weights
+ * sum to srcW*srcH. Sums are kept in the 5/6/5-bit channel domain: at most
+ * 63 * 320 * 320, well inside 32 bits. One reciprocal per pass replaces
+ * the per-pixel divisions.
+ */
+
+#include "resample.h"
+#include <string.h>
+
+bool resample_begin(Resampler* r, int srcW, int srcH, uint16_t* dst, int dstW, int dstH, int dstStride) {
+    if (srcW < 1 || srcH < 1 || srcW > RESAMPLE_MAX_SRC_DIM || srcH > RESAMPLE_MAX_SRC_DIM) return false;
+    if (dstW < 1 || dstH < 1 || dstW > RESAMPLE_MAX_DST_W || dstStride < dstW) return false;
+    r->dst = dst;
+    r->dstW = dstW;
+    r->dstH = dstH;
+    r->dstStride = dstStride;
+    r->srcW = srcW;
+    r->srcH = srcH;
+    r->srcY = 0;
+    r->dstY = 0;
+    r->inv = (1ull << 32) / ((uint32_t)srcW * srcH);
+    r->onRow = nullptr;
+    r->user = nullptr;
+    memset(r->acc, 0, sizeof(r->acc));
+    return true;
+}
+
+void resample_on_row(Resampler* r, void (*onRow)(int y, const uint16_t* row, void* user), void* user) {
+    r->onRow = onRow;
+    r->user = user;
+}
+
+// Add one source row into the accumulators with vertical weight wy
+static void accumulate(Resampler* r, const uint16_t* src, uint32_t wy) {
+    int j = 0;
+    for (int i = 0; i < r->srcW; ++i) {
+        uint16_t p = src[i];
+        uint32_t cr = p >> 11, cg = (p >> 5) & 0x3F, cb = p & 0x1F;
+        int x0 = i * r->dstW, x1 = x0 + r->dstW;
+        while (x0 < x1) {
+            int colEnd = (j + 1) * r->srcW;
+            int wx = (x1 < colEnd ? x1 : colEnd) - x0;
+            uint32_t w = wx * wy;
+            r->acc[0][j] += cr * w;
+            r->acc[1][j] += cg * w;
+            r->acc[2][j] += cb * w;
+            x0 += wx;
+            if (x0 == colEnd) j++;
+        }
+    }
+}
+
+// Divide out the total weight and store (or hand over) the finished destination row
+static void emit_row(Resampler* r) {
+    uint32_t half = (uint32_t)(r->srcW * r->srcH) / 2;
+    uint16_t* out = r->onRow ? r->dst : r->dst + r->dstY * r->dstStride;
+    for (int j = 0; j < r->dstW; ++j) {
+        uint32_t cr = (uint32_t)(((r->acc[0][j] + half) * r->inv) >> 32);
+        uint32_t cg = (uint32_t)(((r->acc[1][j] + half) * r->inv) >> 32);
+        uint32_t cb = (uint32_t)(((r->acc[2][j] + half) * r->inv) >> 32);
+        out[j] = (uint16_t)((cr << 11) | (cg << 5) | cb);
+        r->acc[0][j] = r->acc[1][j] = r->acc[2][j] = 0;
+    }
+    if (r->onRow) r->onRow(r->dstY, out, r->user);
+}
+
+void resample_row(Resampler* r, const uint16_t* src) {
+    if (r->srcY >= r->srcH) return;
+    int y0 = r->srcY * r->dstH, y1 = y0 + r->dstH;
+    r->srcY++;
+
+    // A source row may finish one destination row and start the next (or,
+    // upscaling, cover several)
+    while (y0 < y1) {
+        int rowEnd = (r->dstY + 1) * r->srcH;
+        int wy = (y1 < rowEnd ? y1 : rowEnd) - y0;
+        accumulate(r, src, wy);
+        y0 += wy;
+        if (y0 == rowEnd) {
+            emit_row(r);
+            r->dstY++;
+        }
+    }
+}
+
+void resample_fit(int srcW, int srcH, int boxW, int boxH, int* outW, int* outH) {
+    if (srcW * boxH >= srcH * boxW) {
+        *outW = boxW;
+        *outH = (srcH * boxW + srcW / 2) / srcW;
+    } else {
+        *outH = boxH;
+        *outW = (srcW * boxH + srcH / 2) / srcH;
+    }
+    if (*outW < 1) *outW = 1;
+    if (*outH < 1) *outH = 1;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Widest destination a Resampler can produce (the artwork widget)
+#define RESAMPLE_MAX_DST_W 80
+// Largest source edge (bounds the fixed-point sums)
+#define RESAMPLE_MAX_SRC_DIM 320
+
+// Streaming area-averaging resampler for native RGB565. Source rows are fed
+// top to bottom, once each; every destination pixel is the coverage-weighted
+// mean of the source area it spans (box filter, integer only). Works in both
+// directions. State is one row of accumulators, nothing per source pixel.
+struct Resampler {
+    uint16_t* dst;
+    int dstW, dstH, dstStride;      // Stride in pixels
+    int srcW, srcH;
+    int srcY;                       // Next source row
+    int dstY;                       // Destination row being accumulated
+    uint64_t inv;                   // 2^32 / (srcW * srcH)
+    uint32_t acc[3][RESAMPLE_MAX_DST_W];
+    void (*onRow)(int y, const uint16_t* row, void* user);  // Optional row sink
+    void* user;
+};
+
+// Start a srcW x srcH -> dstW x dstH pass writing into dst. False if a size is out of range.
+bool resample_begin(Resampler* r, int srcW, int srcH, uint16_t* dst, int dstW, int dstH, int dstStride);
+
+// Hand each finished destination row to onRow instead of storing it: dst is
+// then a single row (dstW pixels), reused. Call right after resample_begin.
+void resample_on_row(Resampler* r, void (*onRow)(int y, const uint16_t* row, void* user), void* user);
+
+// Feed the next source row (srcW pixels); completed destination rows are written out
+void resample_row(Resampler* r, const uint16_t* src);
+
+// Fit a srcW x srcH image inside boxW x boxH keeping its aspect ratio
+void resample_fit(int srcW, int srcH, int boxW, int boxH, int* outW, int* outH);
@@ -0,0 +1,658 @@
+/**
+ * @file snapshot_parser.cpp
+ * JSON line -> SnapshotMsg parser shared by the Serial and WiFi ingest tasks
+ *
+ * Kept free of WiFi/RTOS dependencies so it can also be built on the host
+ * (see bench/).
+ */
+
+#include "snapshot_parser.h"
+#include <ArduinoJson.h>
+#include "artwork.h"
+#include "artwork_cache.h"
+#include "art_tiles.h"
+#include "playlist_thumb.h"
+#include "queue_thumbs.h"
+
+// Helper to safely copy Strings into fixed buffers
+static void safeStrCopy(char *dst, size_t dstSize, const String &src) {
+    if (dstSize == 0) return;
+    size_t n = src.length();
+    if (n >= dstSize) n = utf8_clip(src.c_str(), dstSize - 1);
+    memcpy(dst, src.c_str(), n);
+    dst[n] = '\0';
+}
+
+// --- Snapshot string arena ---
+static bool gArenaFullLogged = false;
+
+static void arena_reset(SnapshotMsg &msg) {
+    msg.arena[0] = '\0';       // Shared by every empty string
+    msg.arenaUsed = 1;
+}
+
+// Identifiers (track URI, playlist IDs, queue item IDs) are put first and
+// whole or not at all: a cut ID would name an item that does not exist.
+// Display text goes in after them and is what gets cut when space runs out.
+static_assert(sizeof(MediaData::trackUri) + sizeof(PlaylistInfo::id) + sizeof(PlaylistInfo::snapshotId) +
+              MAX_QUEUE_ITEMS * sizeof(QueueItem::id) < SNAPSHOT_ARENA_SIZE,
+              "snapshot arena must hold every identifier");
+
+// Append an identifier of at most maxLen bytes to the arena; false if it is
+// longer or does not fit
+static bool arena_put_id(SnapshotMsg &msg, const char *src, size_t maxLen, StrRef &out) {
+    out = StrRef{ 0, 0 };
+    size_t n = strlen(src);
+    if (n == 0) return true;
+    if (n > maxLen || n + 1 > (size_t)(SNAPSHOT_ARENA_SIZE - msg.arenaUsed)) return false;
+
+    out.off = msg.arenaUsed;
+    out.len = n;
+    memcpy(msg.arena + out.off, src, n + 1);
+    msg.arenaUsed += n + 1;
+    return true;
+}
+
+// Append src, cut to at most maxLen bytes on a UTF-8 boundary, to the arena
+static StrRef arena_put(SnapshotMsg &msg, const char *src, size_t maxLen) {
+    StrRef ref = { 0, 0 };
+    size_t n = strlen(src);
+    if (n == 0) return ref;
+
+    size_t room = SNAPSHOT_ARENA_SIZE - msg.arenaUsed;
+    if (room <= 1) room = 1;
+    if (maxLen > room - 1) {
+        maxLen = room - 1;
+        if (n > maxLen && !gArenaFullLogged) {
+            Serial.println("[DATA] Snapshot string arena full, strings cut short");
+            gArenaFullLogged = true;
+        }
+    }
+    if (n > maxLen) n = utf8_clip(src, maxLen);
+    if (n == 0) return ref;
+
+    ref.off = msg.arenaUsed;
+    ref.len = n;
+    memcpy(msg.arena + ref.off, src, n);
+    msg.arena[ref.off + n] = '\0';
+    msg.arenaUsed += n + 1;
+    return ref;
+}
+
+// --- Domain change tracking ---
+// Hash of each domain's content in the previous snapshot, and its generation
+static uint32_t gDomainHash[DOMAIN_COUNT];
+static uint32_t gDomainGen[DOMAIN_COUNT];
+
+static uint32_t fnv_bytes(uint32_t h, const void *p, size_t n) {
+    const uint8_t *b = (const uint8_t *)p;
+    for (size_t i = 0; i < n; ++i) h = (h ^ b[i]) * 16777619u;
+    return h;
+}
+
+static uint32_t fnv_str(uint32_t h, const char *s) {
+    return fnv_bytes(h, s, strlen(s) + 1);
+}
+
+static uint32_t fnv_ref(uint32_t h, const SnapshotMsg &msg, StrRef ref) {
+    return fnv_bytes(h, snapshot_str(msg, ref), ref.len + 1);
+}
+
+// Bump the generation of every domain whose content changed. Strings are
+// hashed by content (arena offsets shift with earlier fields); the discord
+// struct is zeroed before parsing, so it can be hashed whole.
+static void stamp_domains(SnapshotMsg &msg) {
+    const uint32_t seed = 2166136261u;
+    uint32_t h[DOMAIN_COUNT];
+
+    uint32_t v = fnv_bytes(seed, &msg.cpu, sizeof(msg.cpu));
+    v = fnv_bytes(v, &msg.mem, sizeof(msg.mem));
+    v = fnv_bytes(v, &msg.gpu, sizeof(msg.gpu));
+    v = fnv_bytes(v, &msg.procCount, sizeof(msg.procCount));
+    for (int i = 0; i < msg.procCount && i < 5; ++i) {
+        v = fnv_ref(v, msg, msg.procs[i]);
+        v = fnv_bytes(v, &msg.procPids[i], sizeof(msg.procPids[i]));
+    }
+    h[DOMAIN_SYSTEM] = v;
+
+    v = fnv_bytes(seed, &msg.hasMedia, sizeof(msg.hasMedia));
+    v = fnv_ref(v, msg, msg.title);
+    v = fnv_ref(v, msg, msg.artist);
+    v = fnv_ref(v, msg, msg.album);
+    v = fnv_ref(v, msg, msg.source);
+    v = fnv_ref(v, msg, msg.trackUri);
+    v = fnv_bytes(v, &msg.position, sizeof(msg.position));
+    v = fnv_bytes(v, &msg.duration, sizeof(msg.duration));
+    uint8_t flags[4] = { msg.isPlaying, msg.shuffle, msg.repeat, msg.isLiked };
+    h[DOMAIN_PLAYBACK] = fnv_bytes(v, flags, sizeof(flags));
+
+    v = fnv_bytes(seed, &msg.hasQueue, sizeof(msg.hasQueue));
+    v = fnv_bytes(v, &msg.queueLen, sizeof(msg.queueLen));
+    for (int i = 0; i < msg.queueLen; ++i) {
+        const SnapQueueItem &q = msg.queue[i];
+        v = fnv_ref(v, msg, q.id);
+        v = fnv_ref(v, msg, q.source);
+        v = fnv_ref(v, msg, q.name);
+        v = fnv_ref(v, msg, q.artist);
+        v = fnv_ref(v, msg, q.album);
+        v = fnv_bytes(v, &q.duration, sizeof(q.duration));
+        v = fnv_bytes(v, &q.isLocal, sizeof(q.isLocal));
+    }
+    h[DOMAIN_QUEUE] = v;
+
+    const SnapPlaylist &pl = msg.playlist;
+    v = fnv_bytes(seed, &msg.hasPlaylist, sizeof(msg.hasPlaylist));
+    v = fnv_ref(v, msg, pl.id);
+    v = fnv_ref(v, msg, pl.name);
+    v = fnv_ref(v, msg, pl.snapshotId);
+    v = fnv_bytes(v, &pl.totalTracks, sizeof(pl.totalTracks));
+    uint8_t plFlags[3] = { pl.isPublic, pl.isCollaborative, pl.hasImage };
+    h[DOMAIN_PLAYLIST] = fnv_bytes(v, plFlags, sizeof(plFlags));
+
+    v = fnv_bytes(seed, &msg.hasDiscord, sizeof(msg.hasDiscord));
+    h[DOMAIN_DISCORD] = fnv_bytes(v, &msg.discord, sizeof(msg.discord));
+
+    h[DOMAIN_ARTWORK] = artwork_generation();
+
+    for (int d = 0; d < DOMAIN_COUNT; ++d) {
+        if (h[d] != gDomainHash[d]) {
+            gDomainHash[d] = h[d];
+            gDomainGen[d]++;
+        }
+        msg.gens.gen[d] = gDomainGen[d];
+    }
+}
+
+// Standalone artwork lines, one key per payload format
+// Format: {"artwork_b64":"BASE64DATA"} or {"artwork_b64": "BASE64DATA"}
+struct ArtworkKind {
+    const char *key;                          // Quoted JSON key
+    bool (*decode)(const char *b64, size_t b64Len);
+    bool raw;                                 // Size from "w"/"h" fields, if present
+};
+
+static const ArtworkKind kArtworkKinds[] = {
+    { "\"artwork_b64\"",     artwork_decode_b64,      true },   // Raw RGB565
+    { "\"artwork_jpg_b64\"", artwork_decode_jpeg_b64, false },  // Baseline JPEG
+    { "\"artwork_png_b64\"", artwork_decode_png_b64,  false },  // PNG (or legacy raw RGB565)
+    { "\"artwork_i8_b64\"",  artwork_decode_i8_b64,   false },  // Palette + indices, stored as is
+};
+
+static const ArtworkKind *find_artwork_kind(const String &input) {
+    if (input.indexOf("cpu_percent") >= 0) return nullptr;  // Full snapshot
+    for (const ArtworkKind &kind : kArtworkKinds) {
+        if (input.indexOf(kind.key) > 0) return &kind;
+    }
+    return nullptr;
+}
+
+bool is_artwork_line(const String &input) {
+    return find_artwork_kind(input) != nullptr;
+}
+
+// Locate the string value of a field in a raw line without parsing it (no escapes)
+static bool find_string_value(const String &input, const char *quotedKey, int &start, int &len, int from = 0) {
+    int k = input.indexOf(quotedKey, from);
+    if (k < 0) return false;
+    int colon = input.indexOf(':', k);
+    int q0 = colon < 0 ? -1 : input.indexOf('"', colon + 1);
+    int q1 = q0 < 0 ? -1 : input.indexOf('"', q0 + 1);
+    if (q1 < 0) return false;
+    start = q0 + 1;
+    len = q1 - start;
+    return true;
+}
+
+// Copy the string value of a short top-level field (e.g. "artwork_key") out of a raw line
+static bool extract_short_string(const String &input, const char *quotedKey, char *out, size_t outSize) {
+    int start, len;
+    if (!find_string_value(input, quotedKey, start, len) || (size_t)len >= outSize) return false;
+    memcpy(out, input.c_str() + start, len);
+    out[len] = '\0';
+    return true;
+}
+
+// Integer value of a field in a raw line (first occurrence of the key)
+static bool extract_int(const String &input, const char *quotedKey, int &out) {
+    int k = input.indexOf(quotedKey);
+    if (k < 0) return false;
+    int colon = input.indexOf(':', k);
+    if (colon < 0) return false;
+    out = atoi(input.c_str() + colon + 1);
+    return true;
+}
+
+// Parse JSON line into SnapshotMsg (POD struct) - artwork handled separately
+bool parse_json_into_msg(const String &input, SnapshotMsg &msg) {
+    // Check if this is a standalone artwork message
+    const ArtworkKind *artKind = find_artwork_kind(input);
+    if (artKind) {
+        Serial.printf("[DATA] Received artwork message (%d chars)\n", input.length());
+        
+        // Debug: print first 100 chars of input
+        Serial.printf("[DATA] First 100 chars: %.100s\n", input.c_str());
+        
+        // Extract base64 directly without JSON parsing to save memory
+        int startIdx = input.indexOf(artKind->key);
+        
+        // Find the colon after the key
+        int colonIdx = input.indexOf(":", startIdx);
+        if (colonIdx < 0) {
+            Serial.printf("[DATA] No colon after %s\n", artKind->key);
+            return false;
+        }
+        
+        // Find the opening quote after the colon
+        int quoteIdx = input.indexOf("\"", colonIdx + 1);
+        if (quoteIdx < 0) {
+            Serial.println("[DATA] No opening quote for value");
+            return false;
+        }
+        startIdx = quoteIdx + 1;  // Start of base64 data
+        
+        int endIdx = input.indexOf("\"", startIdx);
+        if (endIdx < 0 || endIdx <= startIdx) {
+            Serial.println("[DATA] Malformed artwork JSON - no closing quote");
+            return false;
+        }
+        
+        size_t b64len = endIdx - startIdx;
+        Serial.printf("[DATA] %s length: %d\n", artKind->key, b64len);
+        
+        if (b64len > 100 && b64len <= ARTWORK_B64_MAX_LEN) {
+            // Get pointer to base64 data in the input string
+            const char* b64 = input.c_str() + startIdx;
+            int w = 0, h = 0;
+
+            // Answer to an "artwork_prefetch": next track's cover, held in standby
+            char prefetchId[ARTWORK_PREFETCH_ID_LEN];
+            bool prefetch = extract_short_string(input, "\"prefetch_id\"", prefetchId, sizeof(prefetchId));
+            if (prefetch) artwork_prefetch_begin(prefetchId);
+            bool ok = (artKind->raw && extract_int(input, "\"w\"", w) && extract_int(input, "\"h\"", h))
+                      ? artwork_decode_rgb565_b64(b64, b64len, w, h)
+                      : artKind->decode(b64, b64len);
+            Serial.printf("[DATA] Artwork decode: %s\n", ok ? "SUCCESS" : "FAILED");
+
+            // Payload sent after an "artwork_need", or a prefetch that names its
+            // key: cache it under that key
+            char key[ARTWORK_KEY_LEN];
+            if (ok && extract_short_string(input, "\"artwork_key\"", key, sizeof(key)) && artwork_cache_valid_key(key)) {
+                artwork_remember(key);
+            }
+            if (prefetch) artwork_prefetch_end();
+        } else {
+            Serial.printf("[DATA] %s invalid length: %d\n", artKind->key, b64len);
+        }
+        return false;  // Don't queue this as a snapshot
+    }
+
+    // Artwork announce {"artwork_key":"..."}: answer have/need so the server only sends misses
+    if (input.indexOf("\"artwork_key\"") > 0 && input.indexOf("cpu_percent") < 0) {
+        char key[ARTWORK_KEY_LEN];
+        if (extract_short_string(input, "\"artwork_key\"", key, sizeof(key)) && artwork_cache_valid_key(key)) {
+            bool have = artwork_show_cached(key);
+            char reply[64];
+            snprintf(reply, sizeof(reply), "{\"cmd\":\"%s\",\"key\":\"%s\"}",
+                     have ? "artwork_have" : "artwork_need", key);
+            send_reply(reply);
+            Serial.printf("[DATA] Artwork %s: %s\n", key, have ? "have" : "need");
+        } else {
+            Serial.println("[DATA] Bad artwork_key");
+        }
+        return false;
+    }
+
+    // Ambient artwork tiles, matched by hand: tile lines are mostly base64
+    //   {"art_tiles":{"w":240,"h":240}}                                starts an image
+    //   {"art_tile":{"x":0,"y":0,"w":40,"h":40,"rgb565_b64":"..."}}    ("jpg_b64" for JPEG)
+    if (input.indexOf("\"art_tile") > 0 && input.indexOf("cpu_percent") < 0) {
+        int x = 0, y = 0, w = 0, h = 0;
+        extract_int(input, "\"w\"", w);
+        extract_int(input, "\"h\"", h);
+        if (input.indexOf("\"art_tiles\"") > 0) {
+            art_tiles_begin(w, h);
+            return false;
+        }
+
+        extract_int(input, "\"x\"", x);
+        extract_int(input, "\"y\"", y);
+        bool jpeg = input.indexOf("\"jpg_b64\"") > 0;
+        int start, len;
+        if (find_string_value(input, jpeg ? "\"jpg_b64\"" : "\"rgb565_b64\"", start, len)) {
+            art_tiles_put(x, y, w, h, input.c_str() + start, len, jpeg);
+        } else {
+            Serial.println("[DATA] art_tile without data");
+        }
+        return false;
+    }
+
+    // Batched Up Next thumbnails, answering a queue_thumbs need request:
+    //   {"queue_thumbs":[{"id":"spotify:track:...","rgb565_b64":"..."},...]}
+    if (input.indexOf("\"queue_thumbs\"") > 0 && input.indexOf("cpu_percent") < 0) {
+        int pos = input.indexOf("\"queue_thumbs\"");
+        int idStart, idLen, start, len;
+        uint8_t stored = 0;
+        while (find_string_value(input, "\"id\"", idStart, idLen, pos) &&
+               find_string_value(input, "\"rgb565_b64\"", start, len, idStart + idLen)) {
+            char id[sizeof(QueueItem::id)];
+            if (idLen < (int)sizeof(id)) {
+                memcpy(id, input.c_str() + idStart, idLen);
+                id[idLen] = '\0';
+                if (queue_thumbs_store(id, input.c_str() + start, len)) stored++;
+            }
+            pos = start + len + 1;
+        }
+        Serial.printf("[DATA] Queue thumbnails stored: %u\n", stored);
+        return false;
+    }
+
+    // If the message is a one-off 'ack' command (acknowledgement), queue a quick UI update
+    // Parse minimal JSON for ack
+    if (input.indexOf("\"ack\"") > 0) {
+        DynamicJsonDocument ackDoc(256);
+        DeserializationError ackErr = deserializeJson(ackDoc, input);
+        if (!ackErr && ackDoc.containsKey("ack")) {
+            const char* ackVal = ackDoc["ack"] | "";
+            if (strcmp(ackVal, "play") == 0) {
+                ui_event_post(UI_EVENT_PLAY_STATE, 1);
+            } else if (strcmp(ackVal, "pause") == 0) {
+                ui_event_post(UI_EVENT_PLAY_STATE, 0);
+            }
+        }
+        return false; // Not a full snapshot
+    }
+    
+    // Regular system snapshot - need larger buffer for queue data
+    DynamicJsonDocument doc(6144);
+    
+    DeserializationError err = deserializeJson(doc, input);
+    if (err) {
+        return false;
+    }
+
+    // --- System ---
+    float cpu = 0.0f;
+    if (doc.containsKey("cpu_percent_total"))
+        cpu = doc["cpu_percent_total"].as<float>();
+    else if (doc.containsKey("cpu_percent"))
+        cpu = doc["cpu_percent"].as<float>();
+    msg.cpu = cpu;
+    msg.mem = doc.containsKey("mem_percent") ? doc["mem_percent"].as<float>() : 0.0f;
+    msg.gpu = doc.containsKey("gpu_percent") ? doc["gpu_percent"].as<float>() : 0.0f;
+
+    // --- Media identifiers, ahead of all text in the arena ---
+    msg.title = msg.artist = msg.album = StrRef{ 0, 0 };
+    msg.source = msg.trackUri = StrRef{ 0, 0 };
+    msg.hasQueue = false;
+    msg.queueLen = 0;
+    msg.hasPlaylist = false;
+    memset(&msg.playlist, 0, sizeof(msg.playlist));
+    memset(msg.queue, 0, sizeof(msg.queue));
+
+    arena_reset(msg);
+    JsonObject media;
+    if (doc.containsKey("media") && doc["media"].is<JsonObject>()) media = doc["media"].as<JsonObject>();
+    uint8_t queueIds = 0;   // Queue items whose ID is in the arena
+    if (!media.isNull()) {
+        if (!arena_put_id(msg, media["track_uri"] | "", sizeof(MediaData::trackUri) - 1, msg.trackUri)) {
+            Serial.println("[DATA] track_uri too long, dropped");
+        }
+        if (media.containsKey("playlist") && media["playlist"].is<JsonObject>()) {
+            JsonObject pl = media["playlist"].as<JsonObject>();
+            arena_put_id(msg, pl["id"] | "", sizeof(PlaylistInfo::id) - 1, msg.playlist.id);
+            arena_put_id(msg, pl["snapshot_id"] | "", sizeof(PlaylistInfo::snapshotId) - 1, msg.playlist.snapshotId);
+        }
+        if (media.containsKey("queue") && media["queue"].is<JsonArray>()) {
+            // An item without its ID is dropped, with everything after it
+            for (JsonVariant v : media["queue"].as<JsonArray>()) {
+                if (queueIds >= MAX_QUEUE_ITEMS) break;
+                if (!v.is<JsonObject>()) continue;
+                if (!arena_put_id(msg, v["id"] | "", sizeof(QueueItem::id) - 1, msg.queue[queueIds].id)) break;
+                queueIds++;
+            }
+        }
+    }
+
+    msg.procCount = 0;
+    for (int i = 0; i < 5; ++i) {
+        msg.procs[i] = StrRef{ 0, 0 };
+        msg.procPids[i] = 0;
+    }
+
+    // Parse proc_top5 (rich objects) or fallback to cpu_top5_process (legacy string list)
+    if (doc.containsKey("proc_top5") && doc["proc_top5"].is<JsonArray>()) {
+        JsonArray arr = doc["proc_top5"].as<JsonArray>();
+        uint8_t idx = 0;
+        for (JsonVariant v : arr) {
+            if (idx >= 5) break;
+            if (v.is<JsonObject>()) {
+                JsonObject o = v.as<JsonObject>();
+                int pid = o["pid"] | 0;
+                float mem = o["mem"] | 0.0f;
+                const char *name = o["name"] | "";
+                const char *display = o["display_name"] | name;
+                char buf[32];
+                // Display string should hide PID and remove ".exe" suffix
+                // The Python backend provides `display_name`, but fallback to `name`.
+                snprintf(buf, sizeof(buf), "%.1f%% %s", mem, display);
+                msg.procs[idx] = arena_put(msg, buf, sizeof(SystemData::procs[0]) - 1);
+                msg.procPids[idx] = pid;
+                idx++;
+            }
+        }
+        msg.procCount = idx;
+    } else if (doc.containsKey("cpu_top5_process")) {
+        JsonVariant procs = doc["cpu_top5_process"];
+        if (procs.is<JsonArray>()) {
+            JsonArray arr = procs.as<JsonArray>();
+            uint8_t idx = 0;
+                for (JsonVariant v : arr) {
+                if (idx >= 5) break;
+                String line;
+                if (v.is<const char*>()) {
+                    line = String(v.as<const char*>());
+                } else {
+                    serializeJson(v, line);
+                }
+                // Try to strip PID/EXE in fallback string
+                // If line contains a percent and text, we assume it's in format "<mem>% <name>"
+                // Keep as-is but remove .exe if present
+                String clean = line;
+                // Remove .exe suffixs in fallback
+                int posExe = clean.indexOf(".exe");
+                if (posExe >= 0) {
+                    // remove .exe
+                    clean.remove(posExe, 4);
+                }
+                msg.procs[idx] = arena_put(msg, clean.c_str(), sizeof(SystemData::procs[0]) - 1);
+                msg.procPids[idx] = 0; // unknown PID in fallback
+                idx++;
+            }
+            msg.procCount = idx;
+        }
+    }
+
+    // --- Media (optional "media" object from Python) ---
+    msg.hasMedia = false;
+    msg.hasArtwork = false;
+    msg.artworkUpdated = false;
+    msg.position  = 0;
+    msg.duration  = 0;
+    msg.isPlaying = false;
+    msg.shuffle = false;
+    msg.repeat = 0;
+    msg.isLiked = false;
+
+    if (!media.isNull()) {
+        const char *title  = media["title"]   | "No media";
+        const char *artist = media["artist"]  | "";
+        const char *album  = media["album"]   | "";
+        const char *source = media["source"]  | "";
+        int pos       = media["position_seconds"]  | 0;
+        int dur       = media["duration_seconds"]  | 0;
+        bool playing  = media["is_playing"] | false;
+        bool shuffle  = media["shuffle"] | false;
+        bool isLiked  = media["is_liked"] | false;
+        
+        // Parse repeat state: "off", "track", "context"
+        String repeatStr = String(media["repeat"] | "off");
+        uint8_t repeat = 0;  // off
+        if (repeatStr == "track") repeat = 1;
+        else if (repeatStr == "context") repeat = 2;
+
+        // Capped at what the UI model holds
+        msg.title  = arena_put(msg, title,  sizeof(MediaData::title) - 1);
+        msg.artist = arena_put(msg, artist, sizeof(MediaData::artist) - 1);
+        msg.album  = arena_put(msg, album,  sizeof(MediaData::album) - 1);
+        msg.source = arena_put(msg, source, sizeof(MediaData::source) - 1);
+        msg.position = pos;
+        msg.duration = dur;
+        msg.isPlaying = playing;
+        msg.shuffle = shuffle;
+        msg.repeat = repeat;
+        msg.isLiked = isLiked;
+        msg.hasMedia = true;
+        
+        // Parse playlist context if present
+        if (media.containsKey("playlist") && media["playlist"].is<JsonObject>()) {
+            JsonObject pl = media["playlist"].as<JsonObject>();
+            msg.hasPlaylist = true;
+            msg.playlist.name = arena_put(msg, pl["name"] | "", sizeof(PlaylistInfo::name) - 1);
+            msg.playlist.totalTracks = pl["total_tracks"] | 0;
+            msg.playlist.isPublic = pl["is_public"] | false;
+            msg.playlist.isCollaborative = pl["is_collaborative"] | false;
+            const char *thumb = pl["image_thumb_jpg_b64"] | "";
+            msg.playlist.hasImage = thumb[0] != '\0';
+            playlist_thumb_note(snapshot_str(msg, msg.playlist.snapshotId), thumb, strlen(thumb));
+        }
+        
+        // Parse queue if present
+        if (media.containsKey("queue") && media["queue"].is<JsonArray>()) {
+            JsonArray qArr = media["queue"].as<JsonArray>();
+            msg.hasQueue = true;
+            uint8_t idx = 0;
+            for (JsonVariant v : qArr) {
+                if (idx >= queueIds) break;
+                if (!v.is<JsonObject>()) continue;
+                JsonObject q = v.as<JsonObject>();
+                
+                SnapQueueItem &item = msg.queue[idx];   // ID already in place
+                item.source = arena_put(msg, q["source"] | "spotify", sizeof(QueueItem::source) - 1);
+                item.name = arena_put(msg, q["name"] | "", sizeof(QueueItem::name) - 1);
+                item.artist = arena_put(msg, q["artist"] | "", sizeof(QueueItem::artist) - 1);
+                item.album = arena_put(msg, q["album"] | "", sizeof(QueueItem::album) - 1);
+                item.duration = q["duration_seconds"] | 0;
+                item.isLocal = q["is_local"] | false;
+                idx++;
+            }
+            msg.queueLen = idx;
+        }
+
+        const char *ids[MAX_QUEUE_ITEMS];
+        for (uint8_t i = 0; i < msg.queueLen; ++i) ids[i] = snapshot_str(msg, msg.queue[i].id);
+        if (msg.hasQueue) queue_thumbs_note_queue(ids, msg.queueLen);
+
+        // Track change with the cover already in standby: show it now
+        if (artwork_note_track(snapshot_str(msg, msg.trackUri), msg.queueLen ? ids[0] : "")) {
+            msg.hasArtwork = true;
+            msg.artworkUpdated = true;
+        }
+        
+        // Decode artwork directly into global buffer (not queued)
+        if (media.containsKey("artwork_png_b64")) {
+            const char* b64 = media["artwork_png_b64"] | "";
+            size_t b64len = strlen(b64);
+            if (b64len > 0) {
+                msg.hasArtwork = true;
+                if (artwork_decode_png_b64(b64, b64len)) {
+                    msg.artworkUpdated = true;
+                }
+            }
+        } else if (media.containsKey("artwork_jpg_b64")) {
+            const char* b64 = media["artwork_jpg_b64"] | "";
+            size_t b64len = strlen(b64);
+            if (b64len > 0) {
+                msg.hasArtwork = true;
+                if (artwork_decode_jpeg_b64(b64, b64len)) {
+                    msg.artworkUpdated = true;
+                }
+            }
+        }
+    }
+
+    // --- Discord voice call state (optional "discord" object) ---
+    msg.hasDiscord = false;
+    memset(&msg.discord, 0, sizeof(msg.discord));
+    
+    if (doc.containsKey("discord") && doc["discord"].is<JsonObject>()) {
+        JsonObject discord = doc["discord"].as<JsonObject>();
+        
+        // Check if in call - support both "c" (compact) and "in_call" (full)
+        bool inCall = false;
+        if (discord.containsKey("c")) {
+            inCall = discord["c"].as<int>() != 0;
+        } else if (discord.containsKey("in_call")) {
+            inCall = discord["in_call"] | false;
+        }
+        
+        msg.discord.inCall = inCall;
+        
+        if (inCall) {
+            msg.hasDiscord = true;
+            
+            // Channel name - support both "ch" (compact) and "channel" (full)
+            String channelName = "";
+            if (discord.containsKey("ch")) {
+                channelName = String(discord["ch"] | "");
+            } else if (discord.containsKey("channel")) {
+                channelName = String(discord["channel"] | "");
+            }
+            safeStrCopy(msg.discord.channelName, sizeof(msg.discord.channelName), channelName);
+            
+            // Self mute/deaf - support both compact and full
+            msg.discord.selfMuted = discord["sm"] | discord["self_muted"] | false;
+            msg.discord.selfDeafened = discord["sd"] | discord["self_deafened"] | false;
+            
+            // Parse users array - support both "u" (compact) and "users" (full)
+            JsonArray usersArr;
+            if (discord.containsKey("u") && discord["u"].is<JsonArray>()) {
+                usersArr = discord["u"].as<JsonArray>();
+            } else if (discord.containsKey("users") && discord["users"].is<JsonArray>()) {
+                usersArr = discord["users"].as<JsonArray>();
+            }
+            
+            uint8_t idx = 0;
+            for (JsonVariant v : usersArr) {
+                if (idx >= MAX_DISCORD_USERS) break;
+                if (!v.is<JsonObject>()) continue;
+                JsonObject u = v.as<JsonObject>();
+                
+                DiscordUser &user = msg.discord.users[idx];
+                
+                // Name - support both "n" (compact) and "name" (full)
+                String name = "";
+                if (u.containsKey("n")) {
+                    name = String(u["n"] | "");
+                } else if (u.containsKey("name")) {
+                    name = String(u["name"] | "");
+                }
+                safeStrCopy(user.name, sizeof(user.name), name);
+                
+                // Muted - support both "m" (compact) and "muted" (full)
+                user.muted = u["m"] | u["muted"] | false;
+                
+                // Deafened - support both "d" (compact) and "deafened" (full)
+                user.deafened = u["d"] | u["deafened"] | false;
+                
+                // Speaking - support both "s" (compact) and "speaking" (full)
+                user.speaking = u["s"] | u["speaking"] | false;
+                
+                idx++;
+            }
+            msg.discord.userCount = idx;
+        }
+    }
+
+    stamp_domains(msg);
+    return true;
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <Arduino.h>
+#include "data_model.h"
+
+// Parse one JSON line from the server into a SnapshotMsg.
+// Artwork and ack lines are handled in place and return false (nothing to queue).
+bool parse_json_into_msg(const String &input, SnapshotMsg &msg);
+
+// True for standalone artwork lines ({"artwork_b64":...}, {"artwork_jpg_b64":...})
+bool is_artwork_line(const String &input);
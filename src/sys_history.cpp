@@ -0,0 +1,63 @@
+/**
+ * @file sys_history.cpp
+ * Fixed-size rings of CPU/MEM/GPU samples for the Tasks tab sparkline
+ *
+ * Both rings are plain arrays written at a head index that wraps, so a push
+ * is O(1) and memory stays at about 1.3 KB however long the device runs.
+ * The open bucket tracks min/max as samples arrive and is copied into the
+ * coarse ring when it has HISTORY_BUCKET_SAMPLES of them.
+ */
+
+#include "sys_history.h"
+
+struct HistoryRings {
+    uint8_t fine[HISTORY_METRICS][HISTORY_FINE_LEN];
+    uint16_t fineHead;      // Next slot to write
+    uint16_t fineCount;
+    HistoryBucket coarse[HISTORY_METRICS][HISTORY_COARSE_LEN];
+    uint8_t coarseHead;
+    uint8_t coarseCount;
+    HistoryBucket open[HISTORY_METRICS];  // Bucket being filled
+    uint8_t openCount;
+};
+
+static HistoryRings gHist;
+
+bool history_push(const uint8_t sample[HISTORY_METRICS]) {
+    for (int m = 0; m < HISTORY_METRICS; ++m) {
+        uint8_t v = sample[m] > 100 ? 100 : sample[m];
+        gHist.fine[m][gHist.fineHead] = v;
+
+        HistoryBucket& b = gHist.open[m];
+        if (gHist.openCount == 0 || v < b.min) b.min = v;
+        if (gHist.openCount == 0 || v > b.max) b.max = v;
+    }
+    gHist.fineHead = (gHist.fineHead + 1) % HISTORY_FINE_LEN;
+    if (gHist.fineCount < HISTORY_FINE_LEN) gHist.fineCount++;
+
+    if (++gHist.openCount < HISTORY_BUCKET_SAMPLES) return false;
+
+    for (int m = 0; m < HISTORY_METRICS; ++m) gHist.coarse[m][gHist.coarseHead] = gHist.open[m];
+    gHist.coarseHead = (gHist.coarseHead + 1) % HISTORY_COARSE_LEN;
+    if (gHist.coarseCount < HISTORY_COARSE_LEN) gHist.coarseCount++;
+    gHist.openCount = 0;
+    return true;
+}
+
+int history_fine_count() {
+    return gHist.fineCount;
+}
+
+uint8_t history_fine_at(HistoryMetric m, int i) {
+    int oldest = (gHist.fineHead + HISTORY_FINE_LEN - gHist.fineCount) % HISTORY_FINE_LEN;
+    return gHist.fine[m][(oldest + i) % HISTORY_FINE_LEN];
+}
+
+int history_coarse_count() {
+    return gHist.coarseCount;
+}
+
+HistoryBucket history_coarse_at(HistoryMetric m, int i) {
+    int oldest = (gHist.coarseHead + HISTORY_COARSE_LEN - gHist.coarseCount) % HISTORY_COARSE_LEN;
+    return gHist.coarse[m][(oldest + i) % HISTORY_COARSE_LEN];
+}
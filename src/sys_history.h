@@ -0,0 +1,24 @@
+#pragma once
+#include <Arduino.h>
+
+// CPU/MEM/GPU history behind the Tasks tab sparkline (UI task only).
+// Fine ring: one sample per second for 5 minutes. Every 60 samples are folded
+// into a min/max bucket; the coarse ring keeps 60 of those (one hour).
+#define HISTORY_FINE_LEN 300
+#define HISTORY_BUCKET_SAMPLES 60
+#define HISTORY_COARSE_LEN 60
+
+enum HistoryMetric { HISTORY_CPU, HISTORY_MEM, HISTORY_GPU, HISTORY_METRICS };
+
+struct HistoryBucket {
+    uint8_t min, max;
+};
+
+// Append one sample (percent, 0-100) per metric. True if it closed a bucket.
+bool history_push(const uint8_t sample[HISTORY_METRICS]);
+
+// Samples/buckets held; index 0 is the oldest
+int history_fine_count();
+uint8_t history_fine_at(HistoryMetric m, int i);
+int history_coarse_count();
+HistoryBucket history_coarse_at(HistoryMetric m, int i);
@@ -7,6 +7,11 @@
 
 #include "ui.h"
 #include "data_model.h"
+#include "art_fx.h"
+#include "art_tiles.h"
+#include "playlist_thumb.h"
+#include "queue_thumbs.h"
+#include "sys_history.h"
 #include "wifi_manager.h"
 #include <math.h>
 #include <WiFi.h>
@@ -18,11 +23,25 @@ static lv_style_t style_card;
 static lv_style_t style_label_primary;
 static lv_style_t style_label_secondary;
 static lv_style_t style_kill_btn;  // Style for kill buttons
+static lv_style_t style_accent;       // Progress indicator, follows the artwork
+static lv_style_t style_card_accent;  // Music card borders, follows the artwork
+
+#define ACCENT_DEFAULT 0x00BCD4       // LV_PALETTE_CYAN main, until artwork arrives
+#define CARD_BORDER_DEFAULT 0x303050
+#define CARD_BG 0x1a1a2e
 
 // Artwork display - use lv_image with raw RGB565 data
 static lv_image_dsc_t artwork_dsc;
 static bool gArtworkDisplayed = false;
 
+// Blurred cover behind the now-playing card, regenerated per artwork and stretched by LVGL
+static uint16_t gBackdrop[ART_FX_BACKDROP_W * ART_FX_BACKDROP_H];
+static lv_image_dsc_t backdrop_dsc;
+
+// Playlist cover next to the playlist name, and the snapshot it was decoded for
+static lv_image_dsc_t playlist_thumb_dsc;
+static char gPlaylistThumbId[sizeof(PlaylistInfo::snapshotId)];
+
 // --- Task UI holder (using arcs instead of meter in LVGL 9) ---
 struct TaskUI {
     lv_obj_t *cpu_arc;
@@ -32,11 +51,17 @@ struct TaskUI {
     lv_obj_t *mem_label;
     lv_obj_t *gpu_label;
     lv_obj_t *proc_list;
+    lv_obj_t *history_chart;   // CPU/MEM/GPU sparkline under the process list
+    lv_obj_t *history_label;   // "5m" / "1h"
+    lv_chart_series_t *history_series[HISTORY_METRICS];
+    bool history_hour;         // Showing the 1 h min/max view
 };
 static TaskUI taskUi;
 
 // --- Music UI holder ---
 struct MusicUI {
+    lv_obj_t *backdrop_img;   // Blurred artwork behind the card
+    lv_obj_t *card;           // Now-playing card (transparent over the backdrop)
     lv_obj_t *art_container;  // Container for artwork
     lv_obj_t *art_img;        // Image widget for artwork
     lv_obj_t *art_icon;       // Fallback icon label
@@ -47,7 +72,6 @@ struct MusicUI {
     lv_obj_t *progress_label;
     lv_obj_t *play_pause_btn;  // Single toggle button
     lv_obj_t *play_pause_label; // Label to update icon
-    bool is_playing;           // Track current state
     // Shuffle/Repeat/Add-to-Playlist buttons
     lv_obj_t *shuffle_btn;
     lv_obj_t *shuffle_label;
@@ -55,8 +79,6 @@ struct MusicUI {
     lv_obj_t *repeat_label;
     lv_obj_t *add_playlist_btn;
     lv_obj_t *add_playlist_label;
-    bool shuffle_state;        // Current shuffle state
-    uint8_t repeat_state;      // 0=off, 1=track, 2=context
     // Queue page elements
     lv_obj_t *now_playing_page; // Main music page
     lv_obj_t *queue_page;       // Queue page container
@@ -65,6 +87,7 @@ struct MusicUI {
     lv_obj_t *queue_title;      // Queue page title
     lv_obj_t *queue_list;       // List widget for queue items
     lv_obj_t *playlist_label;   // Current playlist name on queue page
+    lv_obj_t *playlist_img;     // Playlist cover left of the name
     // Local progress interpolation
     int last_server_position;   // Last position from server
     int last_server_duration;   // Last duration from server
@@ -77,6 +100,14 @@ static MusicUI musicUi;
 static char gLastQueueItems[MAX_QUEUE_ITEMS][MAX_STR_ESP];
 static uint8_t gLastQueueLen = 255;
 
+// Up Next thumbnails: one image descriptor per atlas slot, and per row the
+// item ID plus the image/icon pair to toggle when its thumbnail arrives
+static lv_image_dsc_t gThumbDsc[QUEUE_THUMB_SLOTS];
+static char gQueueRowIds[MAX_QUEUE_ITEMS][sizeof(QueueItem::id)];
+static lv_obj_t *gQueueRowImg[MAX_QUEUE_ITEMS];
+static lv_obj_t *gQueueRowIcon[MAX_QUEUE_ITEMS];
+static uint32_t gLastThumbGen = 0;
+
 // --- Discord UI holder ---
 // Colors matching Discord's design
 #define DISCORD_BLURPLE     0x5865F2
@@ -126,15 +157,74 @@ struct DiscordUI {
     // Soundboard popup
     lv_obj_t *soundboard_popup;
     lv_obj_t *soundboard_btns[MAX_SOUNDBOARD_SOUNDS];
-    
-    // State cache
-    bool last_in_call;
-    bool last_connected;
-    char last_channel[DISCORD_CHANNEL_LEN];
-    uint8_t last_user_count;
 };
 static DiscordUI discordUi;
 
+// --- Model subjects ---
+// ui_update writes model values into LVGL observer subjects and the widgets
+// bound to them redraw through their observers. LVGL notifies on every set,
+// so writes go through subject_set_int/subject_set_text, which drop values
+// that did not change.
+#define UI_TEXT_LEN MEDIA_TEXT_LEN
+
+struct TextSubject {
+    lv_subject_t subject;
+    char buf[UI_TEXT_LEN];
+};
+
+static lv_subject_t gCpuSubj, gMemSubj, gGpuSubj;   // Percent, rounded
+static TextSubject gTitleSubj, gArtistSubj, gAlbumSubj, gPlaylistSubj;
+static lv_subject_t gPlayingSubj;                    // 0/1
+static lv_subject_t gShuffleSubj;                    // 0/1
+static lv_subject_t gRepeatSubj;                     // 0=off, 1=track, 2=context
+static lv_subject_t gPositionSubj, gDurationSubj;    // Seconds, as displayed
+
+enum { DISCORD_UI_OFFLINE, DISCORD_UI_IDLE, DISCORD_UI_IN_CALL };
+static lv_subject_t gDiscordSubj;
+static TextSubject gChannelSubj;
+
+// Per call participant: absent (row hidden) or a set of status flags
+#define DISCORD_USER_ABSENT   -1
+#define DISCORD_USER_SPEAKING 0x01
+#define DISCORD_USER_MUTED    0x02
+#define DISCORD_USER_DEAFENED 0x04
+static TextSubject gUserNameSubj[MAX_DISCORD_USERS];
+static lv_subject_t gUserStatusSubj[MAX_DISCORD_USERS];
+
+static void text_subject_init(TextSubject &t, const char *initial) {
+    lv_subject_init_string(&t.subject, t.buf, NULL, sizeof(t.buf), initial);
+}
+
+static void subject_set_int(lv_subject_t *subject, int32_t value) {
+    if (lv_subject_get_int(subject) != value) lv_subject_set_int(subject, value);
+}
+
+static void subject_set_text(TextSubject &t, const char *text) {
+    // Compare as stored: a text longer than the buffer matches its truncation
+    if (strncmp(t.buf, text, sizeof(t.buf) - 1) != 0) lv_subject_copy_string(&t.subject, text);
+}
+
+static void init_subjects() {
+    lv_subject_init_int(&gCpuSubj, 0);
+    lv_subject_init_int(&gMemSubj, 0);
+    lv_subject_init_int(&gGpuSubj, 0);
+    text_subject_init(gTitleSubj, "No media playing");
+    text_subject_init(gArtistSubj, "Artist");
+    text_subject_init(gAlbumSubj, "Album");
+    text_subject_init(gPlaylistSubj, "Up Next");
+    lv_subject_init_int(&gPlayingSubj, 0);
+    lv_subject_init_int(&gShuffleSubj, 0);
+    lv_subject_init_int(&gRepeatSubj, 0);
+    lv_subject_init_int(&gPositionSubj, 0);
+    lv_subject_init_int(&gDurationSubj, 0);
+    lv_subject_init_int(&gDiscordSubj, DISCORD_UI_IDLE);
+    text_subject_init(gChannelSubj, "Voice");
+    for (int i = 0; i < MAX_DISCORD_USERS; i++) {
+        text_subject_init(gUserNameSubj[i], "");
+        lv_subject_init_int(&gUserStatusSubj[i], DISCORD_USER_ABSENT);
+    }
+}
+
 // Command buffer size (must match data_model.h)
 #define CMD_MAX_LEN 128
 
@@ -213,34 +303,163 @@ static void discord_soundboard_toggle_cb(lv_event_t *e) {
     }
 }
 
-// Display artwork from the global RGB565 buffer (decoded in data_model)
+// Display the newest artwork front buffer (decoded in artwork.cpp)
 static void update_artwork() {
     if (!musicUi.art_img) return;
-    if (!artwork_is_new()) return;
     
-    // Get the decoded RGB565 data from global buffer
-    uint8_t* rgb565_data = artwork_get_rgb565_buffer();
+    // Swap in the newly published buffer, if any
+    const uint8_t* i8_data = artwork_take_new();
+    if (!i8_data) return;
     
-    // Setup image descriptor for LVGL
+    // Setup image descriptor for LVGL: I8, the palette precedes the indices
     artwork_dsc.header.w = ARTWORK_WIDTH;
     artwork_dsc.header.h = ARTWORK_HEIGHT;
-    artwork_dsc.header.cf = LV_COLOR_FORMAT_RGB565;
-    artwork_dsc.header.stride = ARTWORK_WIDTH * 2;
-    artwork_dsc.data_size = ARTWORK_RGB565_SIZE;
-    artwork_dsc.data = rgb565_data;
+    artwork_dsc.header.cf = LV_COLOR_FORMAT_I8;
+    artwork_dsc.header.stride = ARTWORK_WIDTH;
+    artwork_dsc.data_size = ARTWORK_I8_SIZE;
+    artwork_dsc.data = i8_data;
 
-    // Set image source
+    // Same descriptor, new pixels: drop any cached copy before re-setting the source
+    lv_image_cache_drop(&artwork_dsc);
     lv_image_set_src(musicUi.art_img, &artwork_dsc);
+    lv_obj_invalidate(musicUi.art_img);
+
+    // Accent color from the new cover; every widget using the shared styles follows
+    uint32_t t0 = micros();
+    uint32_t accent = art_fx_accent(i8_data, ACCENT_DEFAULT);
+    lv_color_t accentColor = lv_color_hex(accent);
+    lv_style_set_bg_color(&style_accent, accentColor);
+    lv_style_set_border_color(&style_card_accent, lv_color_mix(accentColor, lv_color_hex(CARD_BG), LV_OPA_50));
+    lv_obj_report_style_change(&style_accent);
+    lv_obj_report_style_change(&style_card_accent);
+
+    // Backdrop from the same pixels; the card turns see-through once it exists
+    if (musicUi.backdrop_img) {
+        art_fx_backdrop(i8_data, gBackdrop);
+        backdrop_dsc.header.w = ART_FX_BACKDROP_W;
+        backdrop_dsc.header.h = ART_FX_BACKDROP_H;
+        backdrop_dsc.header.cf = LV_COLOR_FORMAT_RGB565;
+        backdrop_dsc.header.stride = ART_FX_BACKDROP_W * 2;
+        backdrop_dsc.data_size = sizeof(gBackdrop);
+        backdrop_dsc.data = (const uint8_t *)gBackdrop;
+        lv_image_cache_drop(&backdrop_dsc);
+        lv_image_set_src(musicUi.backdrop_img, &backdrop_dsc);
+        lv_obj_invalidate(musicUi.backdrop_img);
+        lv_obj_remove_flag(musicUi.backdrop_img, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_set_style_bg_opa(musicUi.card, LV_OPA_TRANSP, 0);
+    }
+    Serial.printf("[UI] Accent %06x + backdrop in %u us\n", accent, micros() - t0);
 
     // Show image, hide icon
     lv_obj_remove_flag(musicUi.art_img, LV_OBJ_FLAG_HIDDEN);
     if (musicUi.art_icon) lv_obj_add_flag(musicUi.art_icon, LV_OBJ_FLAG_HIDDEN);
 
     gArtworkDisplayed = true;
-    artwork_clear_new();  // Mark as consumed
     Serial.println("[UI] Artwork displayed");
 }
 
+// Swap in a newly decoded playlist cover; show it only while its playlist snapshot is current
+static void update_playlist_thumb(const MediaData &med) {
+    uint16_t w, h;
+    const char *snapshotId;
+    const uint8_t *px = playlist_thumb_take_new(&w, &h, &snapshotId);
+    if (px) {
+        playlist_thumb_dsc.header.w = w;
+        playlist_thumb_dsc.header.h = h;
+        playlist_thumb_dsc.header.cf = LV_COLOR_FORMAT_RGB565;
+        playlist_thumb_dsc.header.stride = w * 2;
+        playlist_thumb_dsc.data_size = w * h * 2;
+        playlist_thumb_dsc.data = px;
+        lv_image_cache_drop(&playlist_thumb_dsc);
+        lv_image_set_src(musicUi.playlist_img, &playlist_thumb_dsc);
+        lv_obj_invalidate(musicUi.playlist_img);
+        strcpy(gPlaylistThumbId, snapshotId);
+    }
+
+    bool show = med.hasPlaylist && gPlaylistThumbId[0] &&
+                strcmp(med.playlist.snapshotId, gPlaylistThumbId) == 0;
+    if (show == !lv_obj_has_flag(musicUi.playlist_img, LV_OBJ_FLAG_HIDDEN)) return;
+
+    // Narrow the (centered) name and shift it right to make room for the cover
+    lv_obj_set_width(musicUi.playlist_label, show ? 120 : 150);
+    lv_obj_align(musicUi.playlist_label, LV_ALIGN_TOP_MID, show ? 14 : 0, 4);
+    if (show) {
+        lv_obj_update_layout(musicUi.playlist_label);
+        lv_obj_align_to(musicUi.playlist_img, musicUi.playlist_label, LV_ALIGN_OUT_LEFT_MID, -4, 0);
+        lv_obj_remove_flag(musicUi.playlist_img, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(musicUi.playlist_img, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+// Point each atlas slot's descriptor at its pixels (the atlas never moves)
+static void init_queue_thumbs() {
+    const uint8_t *atlas = queue_thumbs_atlas();
+    for (int s = 0; s < QUEUE_THUMB_SLOTS; ++s) {
+        lv_image_dsc_t &dsc = gThumbDsc[s];
+        dsc.header.w = QUEUE_THUMB_SIZE;
+        dsc.header.h = QUEUE_THUMB_SIZE;
+        dsc.header.cf = LV_COLOR_FORMAT_RGB565;
+        dsc.header.stride = QUEUE_THUMB_SIZE * 2;
+        dsc.data_size = QUEUE_THUMB_BYTES;
+        dsc.data = atlas + s * QUEUE_THUMB_BYTES;
+    }
+}
+
+// Show each row's thumbnail if the atlas holds it, the music icon otherwise
+static void refresh_queue_thumbs(bool slotsChanged) {
+    if (slotsChanged) {
+        // Slot pixels were rewritten in place; make LVGL re-read them
+        for (int s = 0; s < QUEUE_THUMB_SLOTS; ++s) lv_image_cache_drop(&gThumbDsc[s]);
+    }
+    for (uint8_t i = 0; i < MAX_QUEUE_ITEMS; ++i) {
+        if (!gQueueRowImg[i]) continue;
+        int slot = queue_thumbs_find(gQueueRowIds[i]);
+        if (slot >= 0) {
+            lv_image_set_src(gQueueRowImg[i], &gThumbDsc[slot]);
+            lv_obj_invalidate(gQueueRowImg[i]);
+            lv_obj_remove_flag(gQueueRowImg[i], LV_OBJ_FLAG_HIDDEN);
+            lv_obj_add_flag(gQueueRowIcon[i], LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_add_flag(gQueueRowImg[i], LV_OBJ_FLAG_HIDDEN);
+            lv_obj_remove_flag(gQueueRowIcon[i], LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+}
+
+// --- Ambient artwork view ---
+// A bare black screen the tile stream is blitted onto (see art_tiles.cpp).
+// Opening and closing switch the server's tile stream on and off, so they go
+// out with send_reply: a throttled send_command could drop the close.
+static lv_obj_t *gMainScreen = nullptr;
+static lv_obj_t *gAmbientScreen = nullptr;
+
+static void ambient_close_cb(lv_event_t *e) {
+    (void)e;
+    art_tiles_set_active(false, 0, 0);
+    lv_screen_load(gMainScreen);
+    send_reply("{\"cmd\":\"art_tiles\",\"size\":0}\n");
+}
+
+static void ambient_open_cb(lv_event_t *e) {
+    (void)e;
+    if (!gAmbientScreen) {
+        gAmbientScreen = lv_obj_create(NULL);
+        lv_obj_set_style_bg_color(gAmbientScreen, lv_color_black(), 0);
+        lv_obj_set_style_bg_opa(gAmbientScreen, LV_OPA_COVER, 0);
+        lv_obj_remove_flag(gAmbientScreen, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_add_event_cb(gAmbientScreen, ambient_close_cb, LV_EVENT_CLICKED, NULL);
+    }
+    lv_screen_load(gAmbientScreen);
+    lv_refr_now(NULL);  // Paint the backdrop now, before any tile lands on the panel
+    art_tiles_set_active(true, 320, 240);
+
+    char out[64];
+    snprintf(out, sizeof(out), "{\"cmd\":\"art_tiles\",\"size\":%d,\"tile\":%d}\n",
+             ART_TILES_MAX_DIM, ART_TILE_SIZE);
+    send_reply(out);
+}
+
 // Debounce for play button to prevent jitter
 static uint32_t gLastPlayPressMs = 0;
 static const uint32_t PLAY_DEBOUNCE_MS = 400;  // Ignore presses within 400ms
@@ -256,12 +475,10 @@ static void play_event_cb(lv_event_t *e) {
     gLastPlayPressMs = now;
     
     // Toggle play/pause locally for immediate UX feedback
-    musicUi.is_playing = !musicUi.is_playing;
-    if (musicUi.play_pause_label) {
-        lv_label_set_text(musicUi.play_pause_label, musicUi.is_playing ? LV_SYMBOL_PAUSE : LV_SYMBOL_PLAY);
-    }
+    bool playing = !lv_subject_get_int(&gPlayingSubj);
+    lv_subject_set_int(&gPlayingSubj, playing);
     // Send the appropriate command based on current state
-    const char *cmd = musicUi.is_playing ? "{\"cmd\":\"play\"}\n" : "{\"cmd\":\"pause\"}\n";
+    const char *cmd = playing ? "{\"cmd\":\"play\"}\n" : "{\"cmd\":\"pause\"}\n";
     send_command(cmd);
 }
 
@@ -293,15 +510,10 @@ static void shuffle_event_cb(lv_event_t *e) {
     gLastNavPressMs = now;
     
     // Toggle shuffle: send opposite of current state
-    bool new_state = !musicUi.shuffle_state;
+    bool new_state = !lv_subject_get_int(&gShuffleSubj);
     
     // Immediate visual feedback
-    musicUi.shuffle_state = new_state;
-    if (new_state) {
-        lv_obj_set_style_bg_color(musicUi.shuffle_btn, lv_palette_main(LV_PALETTE_GREEN), 0);
-    } else {
-        lv_obj_set_style_bg_color(musicUi.shuffle_btn, lv_color_hex(0x404060), 0);
-    }
+    lv_subject_set_int(&gShuffleSubj, new_state);
     
     char out[CMD_MAX_LEN];
     snprintf(out, sizeof(out), "{\"cmd\":\"shuffle\",\"state\":%s}\n", new_state ? "true" : "false");
@@ -318,10 +530,11 @@ static void repeat_event_cb(lv_event_t *e) {
     // Cycle repeat state: 0=off -> 2=context -> 1=track -> 0=off
     uint8_t new_repeat = 0;
     const char *new_state = "off";
-    if (musicUi.repeat_state == 0) {
+    int32_t repeat = lv_subject_get_int(&gRepeatSubj);
+    if (repeat == 0) {
         new_state = "context";
         new_repeat = 2;
-    } else if (musicUi.repeat_state == 2) {
+    } else if (repeat == 2) {
         new_state = "track";
         new_repeat = 1;
     } else {
@@ -330,23 +543,18 @@ static void repeat_event_cb(lv_event_t *e) {
     }
     
     // Immediate visual feedback
-    musicUi.repeat_state = new_repeat;
-    if (new_repeat == 1) {
-        lv_obj_set_style_bg_color(musicUi.repeat_btn, lv_palette_main(LV_PALETTE_ORANGE), 0);
-        lv_label_set_text(musicUi.repeat_label, "1");
-    } else if (new_repeat == 2) {
-        lv_obj_set_style_bg_color(musicUi.repeat_btn, lv_palette_main(LV_PALETTE_CYAN), 0);
-        lv_label_set_text(musicUi.repeat_label, LV_SYMBOL_LOOP);
-    } else {
-        lv_obj_set_style_bg_color(musicUi.repeat_btn, lv_color_hex(0x404060), 0);
-        lv_label_set_text(musicUi.repeat_label, LV_SYMBOL_LOOP);
-    }
+    lv_subject_set_int(&gRepeatSubj, new_repeat);
     
     char out[CMD_MAX_LEN];
     snprintf(out, sizeof(out), "{\"cmd\":\"repeat\",\"state\":\"%s\"}\n", new_state);
     send_command(out);
 }
 
+static void add_playlist_reset_cb(lv_timer_t *t) {
+    (void)t;
+    lv_obj_set_style_bg_color(musicUi.add_playlist_btn, lv_color_hex(0x404060), 0);
+}
+
 // Add to playlist button callback - adds current track to user's default playlist
 static void add_playlist_event_cb(lv_event_t *e) {
     (void)e;
@@ -362,7 +570,9 @@ static void add_playlist_event_cb(lv_event_t *e) {
     snprintf(out, sizeof(out), "{\"cmd\":\"add_to_playlist\"}\n");
     send_command(out);
     
-    // Reset color after brief delay (will be reset on next UI update anyway)
+    // Reset color after a brief delay (one-shot timer, deletes itself)
+    lv_timer_t *reset = lv_timer_create(add_playlist_reset_cb, 300, NULL);
+    lv_timer_set_repeat_count(reset, 1);
 }
 
 // Debounce for queue item clicks (longer to prevent memory issues)
@@ -421,14 +631,16 @@ static void show_now_playing_cb(lv_event_t *e) {
 }
 
 // Throttle UI updates
-static uint32_t gLastUpdateMs = 0;
+// Latest model handed over by loop() (ui_update), applied by ui_frame_cb
+static const SystemData *gModelSys = nullptr;
+static const MediaData *gModelMed = nullptr;
+static const ModelGens *gModelGens = nullptr;
+static ModelGens gUiSeen = {};                   // Domain generations the UI has applied
 static const uint32_t UPDATE_INTERVAL_MS = 100;  // 100ms = 10 updates/sec
 
-// Cache last values to avoid redundant updates
-static int gLastCpu = -1, gLastMem = -1, gLastGpu = -1;
-static String gLastProcs[5];
+// Process list as last built (rows are rebuilt, not bound to subjects)
+static uint32_t gLastProcHash[5];
 static uint8_t gLastProcCount = 255;
-static String gLastTitle = "";
 
 static void format_time(char *buf, size_t buf_len, int seconds) {
     if (seconds < 0) seconds = 0;
@@ -437,6 +649,89 @@ static void format_time(char *buf, size_t buf_len, int seconds) {
     snprintf(buf, buf_len, "%d:%02d", m, s);
 }
 
+static void play_state_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+    lv_obj_t *label = (lv_obj_t *)lv_observer_get_target(observer);
+    lv_label_set_text(label, lv_subject_get_int(subject) ? LV_SYMBOL_PAUSE : LV_SYMBOL_PLAY);
+}
+
+static void repeat_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+    lv_obj_t *btn = (lv_obj_t *)lv_observer_get_target(observer);
+    int32_t mode = lv_subject_get_int(subject);
+    if (mode == 1) {
+        // Repeat one track - orange highlight + "1" indicator
+        lv_obj_set_style_bg_color(btn, lv_palette_main(LV_PALETTE_ORANGE), 0);
+        lv_label_set_text(musicUi.repeat_label, "1");
+    } else if (mode == 2) {
+        // Repeat playlist/context - cyan highlight
+        lv_obj_set_style_bg_color(btn, lv_palette_main(LV_PALETTE_CYAN), 0);
+        lv_label_set_text(musicUi.repeat_label, LV_SYMBOL_LOOP);
+    } else {
+        // Off - default gray
+        lv_obj_set_style_bg_color(btn, lv_color_hex(0x404060), 0);
+        lv_label_set_text(musicUi.repeat_label, LV_SYMBOL_LOOP);
+    }
+}
+
+// Bound to both gPositionSubj and gDurationSubj
+static void progress_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+    (void)subject;
+    lv_obj_t *bar = (lv_obj_t *)lv_observer_get_target(observer);
+    int32_t pos = lv_subject_get_int(&gPositionSubj);
+    int32_t dur = lv_subject_get_int(&gDurationSubj);
+    lv_bar_set_range(bar, 0, dur > 0 ? dur : 1);
+    lv_bar_set_value(bar, pos, LV_ANIM_OFF);
+
+    char pos_str[16], dur_str[16], buf[48];
+    format_time(pos_str, sizeof(pos_str), pos);
+    format_time(dur_str, sizeof(dur_str), dur);
+    snprintf(buf, sizeof(buf), "%s / %s", pos_str, dur_str);
+    lv_label_set_text(musicUi.progress_label, buf);
+}
+
+static void discord_name_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+    DiscordUserUI *u = (DiscordUserUI *)lv_observer_get_user_data(observer);
+    const char *name = lv_subject_get_string(subject);
+    lv_label_set_text(u->name_label, name);
+
+    // Initials: first 2 chars, uppercase
+    char initials[3] = "??";
+    if (name[0]) {
+        initials[0] = toupper((unsigned char)name[0]);
+        initials[1] = toupper((unsigned char)name[1]);
+    }
+    lv_label_set_text(u->initials_label, initials);
+}
+
+static void discord_status_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+    DiscordUserUI *u = (DiscordUserUI *)lv_observer_get_user_data(observer);
+    int32_t flags = lv_subject_get_int(subject);
+    if (flags == DISCORD_USER_ABSENT) return;  // Row is hidden by its flag binding
+
+    // Status text based on speaking/muted/deafened
+    if (flags & DISCORD_USER_SPEAKING) {
+        lv_label_set_text(u->status_label, "Speaking...");
+        lv_obj_set_style_text_color(u->status_label, lv_color_hex(DISCORD_GREEN), 0);
+        // Green ring around avatar when speaking
+        lv_obj_set_style_border_color(u->avatar_circle, lv_color_hex(DISCORD_GREEN), 0);
+        lv_obj_set_style_border_width(u->avatar_circle, 2, 0);
+    } else if (flags & DISCORD_USER_DEAFENED) {
+        lv_label_set_text(u->status_label, "Deafened");
+        lv_obj_set_style_text_color(u->status_label, lv_color_hex(DISCORD_RED), 0);
+        lv_obj_set_style_border_width(u->avatar_circle, 0, 0);
+    } else if (flags & DISCORD_USER_MUTED) {
+        lv_label_set_text(u->status_label, "Muted");
+        lv_obj_set_style_text_color(u->status_label, lv_color_hex(DISCORD_YELLOW), 0);
+        lv_obj_set_style_border_width(u->avatar_circle, 0, 0);
+    } else {
+        lv_label_set_text(u->status_label, "");
+        lv_obj_set_style_border_width(u->avatar_circle, 0, 0);
+    }
+
+    // Per-user mute/deaf button colors
+    lv_obj_set_style_bg_color(u->mute_btn, lv_color_hex((flags & DISCORD_USER_MUTED) ? DISCORD_RED : 0x4F545C), 0);
+    lv_obj_set_style_bg_color(u->deaf_btn, lv_color_hex((flags & DISCORD_USER_DEAFENED) ? DISCORD_RED : 0x4F545C), 0);
+}
+
 // --- Styles ---
 static void init_styles() {
     lv_style_init(&style_screen_bg);
@@ -444,11 +739,17 @@ static void init_styles() {
 
     lv_style_init(&style_card);
     lv_style_set_radius(&style_card, 8);
-    lv_style_set_bg_color(&style_card, lv_color_hex(0x1a1a2e));
+    lv_style_set_bg_color(&style_card, lv_color_hex(CARD_BG));
     lv_style_set_bg_opa(&style_card, LV_OPA_COVER);
     lv_style_set_pad_all(&style_card, 8);
     lv_style_set_border_width(&style_card, 1);
-    lv_style_set_border_color(&style_card, lv_color_hex(0x303050));
+    lv_style_set_border_color(&style_card, lv_color_hex(CARD_BORDER_DEFAULT));
+
+    lv_style_init(&style_accent);
+    lv_style_set_bg_color(&style_accent, lv_color_hex(ACCENT_DEFAULT));
+
+    lv_style_init(&style_card_accent);
+    lv_style_set_border_color(&style_card_accent, lv_color_hex(CARD_BORDER_DEFAULT));
 
     lv_style_init(&style_label_primary);
     lv_style_set_text_color(&style_label_primary, lv_color_hex(0xFFFFFF));
@@ -479,12 +780,25 @@ static void build_music_tab(lv_obj_t *parent) {
     lv_obj_align(now_playing_page, LV_ALIGN_TOP_MID, 0, 0);
     musicUi.now_playing_page = now_playing_page;
 
+    // Backdrop - blurred artwork under everything, hidden until artwork arrives.
+    // Nearest-neighbor stretch: no filtering cost when areas above it redraw.
+    lv_obj_t *backdrop = lv_image_create(now_playing_page);
+    lv_obj_set_size(backdrop, 320, 200);
+    lv_obj_align(backdrop, LV_ALIGN_TOP_LEFT, 0, 0);
+    lv_image_set_inner_align(backdrop, LV_IMAGE_ALIGN_STRETCH);
+    lv_image_set_antialias(backdrop, false);
+    lv_obj_remove_flag(backdrop, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_flag(backdrop, LV_OBJ_FLAG_HIDDEN);
+    musicUi.backdrop_img = backdrop;
+
     // Main card - now playing info
     lv_obj_t *card = lv_obj_create(now_playing_page);
     lv_obj_remove_style_all(card);
     lv_obj_add_style(card, &style_card, 0);
+    lv_obj_add_style(card, &style_card_accent, 0);
     lv_obj_set_size(card, 310, 185);
     lv_obj_align(card, LV_ALIGN_TOP_MID, 0, 2);
+    musicUi.card = card;
 
     // Artwork container
     lv_obj_t *art_container = lv_obj_create(card);
@@ -496,6 +810,8 @@ static void build_music_tab(lv_obj_t *parent) {
     lv_obj_set_style_pad_all(art_container, 0, 0);
     lv_obj_set_style_clip_corner(art_container, true, 0);
     lv_obj_remove_flag(art_container, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(art_container, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(art_container, ambient_open_cb, LV_EVENT_CLICKED, NULL);  // Tap for ambient view
     
     // Image widget for artwork (hidden until we have data)
     lv_obj_t *art_img = lv_image_create(art_container);
@@ -554,7 +870,7 @@ static void build_music_tab(lv_obj_t *parent) {
     lv_bar_set_range(bar, 0, 100);
     lv_bar_set_value(bar, 0, LV_ANIM_OFF);
     lv_obj_set_style_bg_color(bar, lv_color_hex(0x303050), LV_PART_MAIN);
-    lv_obj_set_style_bg_color(bar, lv_palette_main(LV_PALETTE_CYAN), LV_PART_INDICATOR);
+    lv_obj_add_style(bar, &style_accent, LV_PART_INDICATOR);
     lv_obj_set_style_radius(bar, 4, LV_PART_MAIN);
     lv_obj_set_style_radius(bar, 4, LV_PART_INDICATOR);
 
@@ -573,6 +889,12 @@ static void build_music_tab(lv_obj_t *parent) {
     musicUi.progress_bar = bar;
     musicUi.progress_label = time_label;
 
+    lv_label_bind_text(title, &gTitleSubj.subject, NULL);
+    lv_label_bind_text(artist, &gArtistSubj.subject, NULL);
+    lv_label_bind_text(album, &gAlbumSubj.subject, NULL);
+    lv_subject_add_observer_obj(&gPositionSubj, progress_observer_cb, bar, NULL);
+    lv_subject_add_observer_obj(&gDurationSubj, progress_observer_cb, bar, NULL);
+
     // Secondary controls row: shuffle / like / repeat - positioned on the RIGHT side
     lv_obj_t *secondary_controls = lv_obj_create(card);
     lv_obj_remove_style_all(secondary_controls);
@@ -593,9 +915,11 @@ static void build_music_tab(lv_obj_t *parent) {
     lv_obj_set_style_text_font(shuffle_label, &lv_font_montserrat_12, 0);
     lv_obj_center(shuffle_label);
     lv_obj_add_event_cb(shuffle_btn, shuffle_event_cb, LV_EVENT_CLICKED, NULL);
+    // Highlighted (checked) while shuffle is on
+    lv_obj_set_style_bg_color(shuffle_btn, lv_palette_main(LV_PALETTE_GREEN), LV_STATE_CHECKED);
+    lv_obj_bind_state_if_eq(shuffle_btn, &gShuffleSubj, LV_STATE_CHECKED, 1);
     musicUi.shuffle_btn = shuffle_btn;
     musicUi.shuffle_label = shuffle_label;
-    musicUi.shuffle_state = false;
 
     // Add to playlist button (+)
     lv_obj_t *add_btn = lv_btn_create(secondary_controls);
@@ -622,7 +946,7 @@ static void build_music_tab(lv_obj_t *parent) {
     lv_obj_add_event_cb(repeat_btn, repeat_event_cb, LV_EVENT_CLICKED, NULL);
     musicUi.repeat_btn = repeat_btn;
     musicUi.repeat_label = repeat_label;
-    musicUi.repeat_state = 0;  // 0=off, 1=track, 2=context
+    lv_subject_add_observer_obj(&gRepeatSubj, repeat_observer_cb, repeat_btn, NULL);
 
     // Controls: back / play-pause / next - at bottom
     lv_obj_t *controls = lv_obj_create(card);
@@ -652,7 +976,7 @@ static void build_music_tab(lv_obj_t *parent) {
     // Store references for updating the icon
     musicUi.play_pause_btn = play_btn;
     musicUi.play_pause_label = play_label;
-    musicUi.is_playing = false;
+    lv_subject_add_observer_obj(&gPlayingSubj, play_state_observer_cb, play_label, NULL);
 
     lv_obj_t *next_btn = lv_btn_create(controls);
     lv_obj_set_size(next_btn, 50, 28);
@@ -673,6 +997,7 @@ static void build_music_tab(lv_obj_t *parent) {
     lv_obj_t *queue_card = lv_obj_create(queue_page);
     lv_obj_remove_style_all(queue_card);
     lv_obj_add_style(queue_card, &style_card, 0);
+    lv_obj_add_style(queue_card, &style_card_accent, 0);
     lv_obj_set_size(queue_card, 310, 185);
     lv_obj_align(queue_card, LV_ALIGN_TOP_MID, 0, 2);
 
@@ -695,8 +1020,14 @@ static void build_music_tab(lv_obj_t *parent) {
     lv_label_set_long_mode(playlist_label, LV_LABEL_LONG_SCROLL_CIRCULAR);
     lv_obj_set_width(playlist_label, 150);
     lv_obj_align(playlist_label, LV_ALIGN_TOP_MID, 0, 4);
+    lv_label_bind_text(playlist_label, &gPlaylistSubj.subject, NULL);
     musicUi.playlist_label = playlist_label;
 
+    // Playlist cover - left of the name, hidden until one is decoded
+    lv_obj_t *playlist_img = lv_image_create(queue_card);
+    lv_obj_add_flag(playlist_img, LV_OBJ_FLAG_HIDDEN);
+    musicUi.playlist_img = playlist_img;
+
     // Queue list - scrollable
     lv_obj_t *queue_list = lv_list_create(queue_card);
     lv_obj_set_size(queue_list, 294, 145);
@@ -710,6 +1041,62 @@ static void build_music_tab(lv_obj_t *parent) {
 }
 
 // --- TASK TAB --- (using arcs for LVGL 9)
+// --- Usage history sparkline (Tasks tab) ---
+#define HISTORY_STALE_MS 5000             // No snapshot for this long: stop sampling
+static uint32_t gLastSystemMs = 0;
+
+// Refill the chart from the rings; only on a view switch
+static void history_reload() {
+    lv_obj_t *chart = taskUi.history_chart;
+    lv_chart_set_point_count(chart, taskUi.history_hour ? HISTORY_COARSE_LEN * 2 : HISTORY_FINE_LEN);
+    for (int m = 0; m < HISTORY_METRICS; ++m) {
+        lv_chart_series_t *ser = taskUi.history_series[m];
+        lv_chart_set_all_value(chart, ser, LV_CHART_POINT_NONE);
+        if (taskUi.history_hour) {
+            // Min then max per bucket: the line sweeps each minute's range
+            for (int i = 0; i < history_coarse_count(); ++i) {
+                HistoryBucket b = history_coarse_at((HistoryMetric)m, i);
+                lv_chart_set_next_value(chart, ser, b.min);
+                lv_chart_set_next_value(chart, ser, b.max);
+            }
+        } else {
+            for (int i = 0; i < history_fine_count(); ++i) {
+                lv_chart_set_next_value(chart, ser, history_fine_at((HistoryMetric)m, i));
+            }
+        }
+    }
+    lv_label_set_text(taskUi.history_label, taskUi.history_hour ? "1h" : "5m");
+}
+
+static void history_toggle_cb(lv_event_t *e) {
+    (void)e;
+    taskUi.history_hour = !taskUi.history_hour;
+    history_reload();
+}
+
+// Once a second: sample the latest values and shift the new point(s) in
+static void history_timer_cb(lv_timer_t *t) {
+    (void)t;
+    if (!gLastSystemMs || lv_tick_get() - gLastSystemMs > HISTORY_STALE_MS) return;
+
+    uint8_t sample[HISTORY_METRICS];
+    sample[HISTORY_CPU] = LV_CLAMP(0, lv_subject_get_int(&gCpuSubj), 100);
+    sample[HISTORY_MEM] = LV_CLAMP(0, lv_subject_get_int(&gMemSubj), 100);
+    sample[HISTORY_GPU] = LV_CLAMP(0, lv_subject_get_int(&gGpuSubj), 100);
+    bool closed = history_push(sample);
+
+    for (int m = 0; m < HISTORY_METRICS; ++m) {
+        lv_chart_series_t *ser = taskUi.history_series[m];
+        if (!taskUi.history_hour) {
+            lv_chart_set_next_value(taskUi.history_chart, ser, sample[m]);
+        } else if (closed) {
+            HistoryBucket b = history_coarse_at((HistoryMetric)m, history_coarse_count() - 1);
+            lv_chart_set_next_value(taskUi.history_chart, ser, b.min);
+            lv_chart_set_next_value(taskUi.history_chart, ser, b.max);
+        }
+    }
+}
+
 static void build_task_tab(lv_obj_t *parent) {
     lv_obj_add_style(parent, &style_screen_bg, 0);
     lv_obj_set_scrollbar_mode(parent, LV_SCROLLBAR_MODE_OFF);
@@ -804,13 +1191,52 @@ static void build_task_tab(lv_obj_t *parent) {
     lv_obj_t *list = lv_list_create(right_panel);
     // Move the list down slightly to avoid overlap with the title and ensure the top
     // row is visible (was getting cut off on some displays / fonts).
-    lv_obj_set_size(list, 165, 150);
+    lv_obj_set_size(list, 165, 100);
     lv_obj_align(list, LV_ALIGN_TOP_MID, 0, 20);
     lv_obj_set_style_bg_color(list, lv_color_hex(0x151525), 0);
     lv_obj_set_style_border_width(list, 0, 0);
     lv_obj_set_style_pad_all(list, 4, 0);
     lv_obj_set_style_pad_top(list, 6, 0);
 
+    // Usage history: one chart, a series per arc color; tap to switch 5 min / 1 h
+    lv_obj_t *chart = lv_chart_create(right_panel);
+    lv_obj_set_size(chart, 165, 38);
+    lv_obj_align(chart, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_chart_set_type(chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_update_mode(chart, LV_CHART_UPDATE_MODE_SHIFT);
+    lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, 0, 100);
+    lv_chart_set_div_line_count(chart, 0, 0);
+    lv_chart_set_point_count(chart, HISTORY_FINE_LEN);
+    lv_obj_set_style_bg_color(chart, lv_color_hex(0x151525), 0);
+    lv_obj_set_style_border_width(chart, 0, 0);
+    lv_obj_set_style_pad_all(chart, 2, 0);
+    lv_obj_set_style_line_width(chart, 1, LV_PART_ITEMS);
+    lv_obj_set_style_size(chart, 0, 0, LV_PART_INDICATOR);  // No point markers
+    taskUi.history_series[HISTORY_CPU] = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_CYAN), LV_CHART_AXIS_PRIMARY_Y);
+    taskUi.history_series[HISTORY_MEM] = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_ORANGE), LV_CHART_AXIS_PRIMARY_Y);
+    taskUi.history_series[HISTORY_GPU] = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_GREEN), LV_CHART_AXIS_PRIMARY_Y);
+    for (lv_chart_series_t *ser : taskUi.history_series) lv_chart_set_all_value(chart, ser, LV_CHART_POINT_NONE);
+    lv_obj_add_flag(chart, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(chart, history_toggle_cb, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_t *span_label = lv_label_create(chart);
+    lv_obj_add_style(span_label, &style_label_secondary, 0);
+    lv_obj_set_style_text_font(span_label, &lv_font_montserrat_10, 0);
+    lv_label_set_text(span_label, "5m");
+    lv_obj_align(span_label, LV_ALIGN_TOP_RIGHT, 0, -2);
+
+    taskUi.history_chart = chart;
+    taskUi.history_label = span_label;
+    taskUi.history_hour = false;
+    lv_timer_create(history_timer_cb, 1000, NULL);
+
+    lv_arc_bind_value(cpu_arc, &gCpuSubj);
+    lv_arc_bind_value(mem_arc, &gMemSubj);
+    lv_arc_bind_value(gpu_arc, &gGpuSubj);
+    lv_label_bind_text(cpu_label, &gCpuSubj, "CPU: %d%%");
+    lv_label_bind_text(mem_label, &gMemSubj, "MEM: %d%%");
+    lv_label_bind_text(gpu_label, &gGpuSubj, "GPU: %d%%");
+
     taskUi.cpu_arc = cpu_arc;
     taskUi.mem_arc = mem_arc;
     taskUi.gpu_arc = gpu_arc;
@@ -841,7 +1267,7 @@ static void build_discord_tab(lv_obj_t *parent) {
     lv_obj_remove_style_all(not_conn);
     lv_obj_set_size(not_conn, 310, 180);
     lv_obj_center(not_conn);
-    lv_obj_add_flag(not_conn, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_bind_flag_if_not_eq(not_conn, &gDiscordSubj, LV_OBJ_FLAG_HIDDEN, DISCORD_UI_OFFLINE);
     discordUi.not_connected_container = not_conn;
     
     lv_obj_t *nc_label = lv_label_create(not_conn);
@@ -855,6 +1281,7 @@ static void build_discord_tab(lv_obj_t *parent) {
     lv_obj_remove_style_all(not_call);
     lv_obj_set_size(not_call, 310, 180);
     lv_obj_center(not_call);
+    lv_obj_bind_flag_if_not_eq(not_call, &gDiscordSubj, LV_OBJ_FLAG_HIDDEN, DISCORD_UI_IDLE);
     discordUi.not_in_call_container = not_call;
     
     lv_obj_t *big_icon = lv_label_create(not_call);
@@ -880,7 +1307,7 @@ static void build_discord_tab(lv_obj_t *parent) {
     lv_obj_remove_style_all(in_call);
     lv_obj_set_size(in_call, 310, 180);
     lv_obj_align(in_call, LV_ALIGN_TOP_LEFT, 0, 0);
-    lv_obj_add_flag(in_call, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_bind_flag_if_not_eq(in_call, &gDiscordSubj, LV_OBJ_FLAG_HIDDEN, DISCORD_UI_IN_CALL);
     lv_obj_remove_flag(in_call, LV_OBJ_FLAG_SCROLLABLE);
     discordUi.in_call_container = in_call;
 
@@ -905,7 +1332,7 @@ static void build_discord_tab(lv_obj_t *parent) {
     
     // Channel name
     lv_obj_t *chan_lbl = lv_label_create(header);
-    lv_label_set_text(chan_lbl, "# Voice");
+    lv_label_bind_text(chan_lbl, &gChannelSubj.subject, "# %s");
     lv_obj_set_style_text_color(chan_lbl, lv_color_hex(0xFFFFFF), 0);
     lv_obj_set_style_text_font(chan_lbl, &lv_font_montserrat_12, 0);
     lv_label_set_long_mode(chan_lbl, LV_LABEL_LONG_DOT);
@@ -964,7 +1391,7 @@ static void build_discord_tab(lv_obj_t *parent) {
         lv_obj_set_style_bg_color(row, lv_color_hex(DISCORD_DARKER_BG), 0);
         lv_obj_set_style_bg_opa(row, LV_OPA_COVER, 0);
         lv_obj_set_style_radius(row, 4, 0);
-        lv_obj_add_flag(row, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_bind_flag_if_eq(row, &gUserStatusSubj[i], LV_OBJ_FLAG_HIDDEN, DISCORD_USER_ABSENT);
         lv_obj_remove_flag(row, LV_OBJ_FLAG_SCROLLABLE);
         discordUi.users[i].container = row;
         discordUi.users[i].user_index = i;
@@ -982,7 +1409,6 @@ static void build_discord_tab(lv_obj_t *parent) {
         
         // Initials in avatar
         lv_obj_t *initials = lv_label_create(avatar);
-        lv_label_set_text(initials, "??");
         lv_obj_set_style_text_color(initials, lv_color_hex(0xFFFFFF), 0);
         lv_obj_set_style_text_font(initials, &lv_font_montserrat_10, 0);
         lv_obj_center(initials);
@@ -990,7 +1416,6 @@ static void build_discord_tab(lv_obj_t *parent) {
 
         // Name label
         lv_obj_t *name = lv_label_create(row);
-        lv_label_set_text(name, "Username");
         lv_obj_set_style_text_color(name, lv_color_hex(DISCORD_LIGHT_TEXT), 0);
         lv_obj_set_style_text_font(name, &lv_font_montserrat_12, 0);
         lv_label_set_long_mode(name, LV_LABEL_LONG_DOT);
@@ -1033,6 +1458,10 @@ static void build_discord_tab(lv_obj_t *parent) {
         lv_obj_set_style_text_font(ud_icon, &lv_font_montserrat_10, 0);
         lv_obj_center(ud_icon);
         discordUi.users[i].deaf_btn = user_deaf;
+
+        // Widgets are complete: the observers fill them in right away
+        lv_subject_add_observer_obj(&gUserNameSubj[i], discord_name_observer_cb, row, &discordUi.users[i]);
+        lv_subject_add_observer_obj(&gUserStatusSubj[i], discord_status_observer_cb, row, &discordUi.users[i]);
     }
 
     // ========== SOUNDBOARD POPUP (overlay) ==========
@@ -1090,12 +1519,6 @@ static void build_discord_tab(lv_obj_t *parent) {
         
         discordUi.soundboard_btns[i] = sound_btn;
     }
-
-    // Initialize cache
-    discordUi.last_in_call = false;
-    discordUi.last_connected = true;
-    discordUi.last_channel[0] = '\0';
-    discordUi.last_user_count = 0;
 }
 
 // --- SETTINGS TAB with Network Info ---
@@ -1496,11 +1919,16 @@ static void build_settings_tab(lv_obj_t *parent) {
 
 // --- Public API ---
 
+static void ui_frame_cb(lv_timer_t *t);
+
 void ui_init() {
     init_styles();
+    init_subjects();
+    init_queue_thumbs();
 
     lv_obj_t *scr = lv_screen_active();
     lv_obj_add_style(scr, &style_screen_bg, 0);
+    gMainScreen = scr;
 
     // LVGL 9 tabview API
     lv_obj_t *tabview = lv_tabview_create(scr);
@@ -1529,71 +1957,24 @@ void ui_init() {
     build_task_tab(tab_tasks);
     build_discord_tab(tab_discord);
     build_settings_tab(tab_settings);
-}
 
-void ui_update(const SystemData &sys, const MediaData &med) {
-    // Throttle updates
-    uint32_t now = millis();
-    if (now - gLastUpdateMs < UPDATE_INTERVAL_MS) {
-        return;
-    }
-    gLastUpdateMs = now;
-
-    char buf[64];
-
-    // --- Check for new artwork (decoded in data_model, stored in global buffer) ---
-    // Always check artwork_is_new() since artwork may arrive as a standalone message
-    if (artwork_is_new()) {
-        update_artwork();
-    }
-
-    // --- Update network status in settings (every 2 seconds) ---
-    static uint32_t lastNetUpdate = 0;
-    if (now - lastNetUpdate > 2000) {
-        lastNetUpdate = now;
-        update_wifi_status_display();
-    }
-    
-    // --- Check for scan completion ---
-    if (settingsUi.scan_pending && wifiMgr.isScanComplete()) {
-        settingsUi.scan_pending = false;
-        lv_label_set_text(lv_obj_get_child(settingsUi.scan_btn, 0), LV_SYMBOL_REFRESH " Scan Networks");
-        update_network_list();
-    }
+    // Model changes are applied at a bounded rate, inside lv_timer_handler()
+    // right before the display refresh
+    lv_timer_create(ui_frame_cb, UPDATE_INTERVAL_MS, NULL);
+}
 
-    // --- Tasks ---
-    int cpu_i = (int)round(sys.cpu);
-    int mem_i = (int)round(sys.mem);
-    int gpu_i = (int)round(sys.gpu);
-
-    // Update arcs
-    if (taskUi.cpu_arc) lv_arc_set_value(taskUi.cpu_arc, cpu_i);
-    if (taskUi.mem_arc) lv_arc_set_value(taskUi.mem_arc, mem_i);
-    if (taskUi.gpu_arc) lv_arc_set_value(taskUi.gpu_arc, gpu_i);
-
-    // Update labels only if changed
-    if (cpu_i != gLastCpu && taskUi.cpu_label) {
-        snprintf(buf, sizeof(buf), "CPU: %d%%", cpu_i);
-        lv_label_set_text(taskUi.cpu_label, buf);
-        gLastCpu = cpu_i;
-    }
-    if (mem_i != gLastMem && taskUi.mem_label) {
-        snprintf(buf, sizeof(buf), "MEM: %d%%", mem_i);
-        lv_label_set_text(taskUi.mem_label, buf);
-        gLastMem = mem_i;
-    }
-    if (gpu_i != gLastGpu && taskUi.gpu_label) {
-        snprintf(buf, sizeof(buf), "GPU: %d%%", gpu_i);
-        lv_label_set_text(taskUi.gpu_label, buf);
-        gLastGpu = gpu_i;
-    }
+// --- Tasks tab: arcs, labels and the process list ---
+static void update_system(const SystemData &sys) {
+    subject_set_int(&gCpuSubj, (int)round(sys.cpu));
+    subject_set_int(&gMemSubj, (int)round(sys.mem));
+    subject_set_int(&gGpuSubj, (int)round(sys.gpu));
 
     // Update process list only if changed
     if (taskUi.proc_list) {
         bool procsChanged = (sys.procCount != gLastProcCount);
         if (!procsChanged) {
             for (uint8_t i = 0; i < sys.procCount && i < 5; ++i) {
-                if (sys.procs[i] != gLastProcs[i]) {
+                if (sys.procHash[i] != gLastProcHash[i]) {
                     procsChanged = true;
                     break;
                 }
@@ -1602,7 +1983,7 @@ void ui_update(const SystemData &sys, const MediaData &med) {
         if (procsChanged) {
             lv_obj_clean(taskUi.proc_list);
             for (uint8_t i = 0; i < sys.procCount; ++i) {
-                if (!sys.procs[i].length()) continue;
+                if (!sys.procs[i][0]) continue;
                 
                 // Create a custom row with kill button + text
                 lv_obj_t *row = lv_obj_create(taskUi.proc_list);
@@ -1626,7 +2007,7 @@ void ui_update(const SystemData &sys, const MediaData &med) {
                 // Process name label (store the full text for PID extraction)
                 lv_obj_t *proc_label = lv_label_create(row);
                 lv_obj_add_style(proc_label, &style_label_primary, 0);
-                lv_label_set_text(proc_label, sys.procs[i].c_str());
+                lv_label_set_text(proc_label, sys.procs[i]);
                 lv_obj_set_style_text_font(proc_label, &lv_font_montserrat_12, 0);
                 // Clip long names horizontally, but prefer scrolling to avoid truncated display
                 lv_label_set_long_mode(proc_label, LV_LABEL_LONG_SCROLL_CIRCULAR);
@@ -1639,336 +2020,274 @@ void ui_update(const SystemData &sys, const MediaData &med) {
                 lv_obj_set_user_data(proc_label, (void*)(intptr_t)sys.procPids[i]);
                 lv_obj_add_event_cb(kill_btn, kill_proc_event_cb, LV_EVENT_CLICKED, proc_label);
                 
-                gLastProcs[i] = sys.procs[i];
+                gLastProcHash[i] = sys.procHash[i];
             }
             gLastProcCount = sys.procCount;
         }
     }
+}
 
-    // --- Music ---
-    if (med.valid) {
-        // Only update title if changed
-        if (med.title != gLastTitle && musicUi.title_label) {
-            lv_label_set_text(musicUi.title_label, med.title.c_str());
-            gLastTitle = med.title;
-        }
-        if (musicUi.artist_label)
-            lv_label_set_text(musicUi.artist_label, med.artist.c_str());
-        if (musicUi.album_label)
-            lv_label_set_text(musicUi.album_label, med.album.c_str());
-
-        int dur = med.duration > 0 ? med.duration : 1;
-        int server_pos = med.position;
-        if (server_pos < 0) server_pos = 0;
-        if (server_pos > dur) server_pos = dur;
-        
-        // Update server position tracking for interpolation
-        uint32_t now_ms = lv_tick_get();
-        if (server_pos != musicUi.last_server_position || dur != musicUi.last_server_duration) {
-            // Server sent new position - sync immediately
-            musicUi.last_server_position = server_pos;
-            musicUi.last_server_duration = dur;
-            musicUi.last_update_ms = now_ms;
-            musicUi.interpolated_position = server_pos;
-        }
-        
-        // Use interpolated position for display (updated in ui_tick)
-        int display_pos = musicUi.interpolated_position;
-        if (display_pos > dur) display_pos = dur;
-
-        if (musicUi.progress_bar) {
-            lv_bar_set_range(musicUi.progress_bar, 0, dur);
-            lv_bar_set_value(musicUi.progress_bar, display_pos, LV_ANIM_OFF);
-        }
+// --- Now playing: track text, progress and the transport buttons ---
+static void update_playback(const MediaData &med) {
+    subject_set_text(gTitleSubj, med.title);
+    subject_set_text(gArtistSubj, med.artist);
+    subject_set_text(gAlbumSubj, med.album);
 
-        if (musicUi.progress_label) {
-            char pos_str[16];
-            char dur_str[16];
-            format_time(pos_str, sizeof(pos_str), display_pos);
-            format_time(dur_str, sizeof(dur_str), dur);
-            snprintf(buf, sizeof(buf), "%s / %s", pos_str, dur_str);
-            lv_label_set_text(musicUi.progress_label, buf);
-        }
-        
-        // Update play/pause button icon based on current state
-        if (musicUi.play_pause_label && med.isPlaying != musicUi.is_playing) {
-            musicUi.is_playing = med.isPlaying;
-            lv_label_set_text(musicUi.play_pause_label, med.isPlaying ? LV_SYMBOL_PAUSE : LV_SYMBOL_PLAY);
-        }
-        
-        // Update shuffle button state (highlight when active)
-        if (musicUi.shuffle_btn) {
-            bool shuffle_active = med.shuffle;
-            if (shuffle_active != musicUi.shuffle_state) {
-                musicUi.shuffle_state = shuffle_active;
-                if (shuffle_active) {
-                    // Active: bright green
-                    lv_obj_set_style_bg_color(musicUi.shuffle_btn, lv_palette_main(LV_PALETTE_GREEN), 0);
-                } else {
-                    // Inactive: default gray
-                    lv_obj_set_style_bg_color(musicUi.shuffle_btn, lv_color_hex(0x404060), 0);
-                }
-            }
-        }
-        
-        // Update repeat button state and icon (0=off, 1=track, 2=context)
-        if (musicUi.repeat_btn && musicUi.repeat_label) {
-            if (med.repeat != musicUi.repeat_state) {
-                musicUi.repeat_state = med.repeat;
-                
-                if (musicUi.repeat_state == 1) {
-                    // Repeat one track - orange highlight + "1" indicator
-                    lv_obj_set_style_bg_color(musicUi.repeat_btn, lv_palette_main(LV_PALETTE_ORANGE), 0);
-                    lv_label_set_text(musicUi.repeat_label, "1");
-                } else if (musicUi.repeat_state == 2) {
-                    // Repeat playlist/context - cyan highlight
-                    lv_obj_set_style_bg_color(musicUi.repeat_btn, lv_palette_main(LV_PALETTE_CYAN), 0);
-                    lv_label_set_text(musicUi.repeat_label, LV_SYMBOL_LOOP);
-                } else {
-                    // Off - default gray
-                    lv_obj_set_style_bg_color(musicUi.repeat_btn, lv_color_hex(0x404060), 0);
-                    lv_label_set_text(musicUi.repeat_label, LV_SYMBOL_LOOP);
-                }
-            }
-        }
-        
-        // Reset add-to-playlist button color (in case it was highlighted)
-        if (musicUi.add_playlist_btn) {
-            lv_obj_set_style_bg_color(musicUi.add_playlist_btn, lv_color_hex(0x404060), 0);
-        }
-        
-        // Show/hide artwork placeholder based on whether we have displayed artwork
-        if (!gArtworkDisplayed && musicUi.art_icon) {
-            // No artwork yet - show icon
-            lv_obj_remove_flag(musicUi.art_icon, LV_OBJ_FLAG_HIDDEN);
-            if (musicUi.art_img) lv_obj_add_flag(musicUi.art_img, LV_OBJ_FLAG_HIDDEN);
-        }
+    int dur = med.duration > 0 ? med.duration : 1;
+    int server_pos = med.position;
+    if (server_pos < 0) server_pos = 0;
+    if (server_pos > dur) server_pos = dur;
+    
+    // Update server position tracking for interpolation
+    uint32_t now_ms = lv_tick_get();
+    if (server_pos != musicUi.last_server_position || dur != musicUi.last_server_duration) {
+        // Server sent new position - sync immediately
+        musicUi.last_server_position = server_pos;
+        musicUi.last_server_duration = dur;
+        musicUi.last_update_ms = now_ms;
+        musicUi.interpolated_position = server_pos;
+    }
+    
+    // Use interpolated position for display (updated in ui_tick)
+    int display_pos = musicUi.interpolated_position;
+    if (display_pos > dur) display_pos = dur;
+    subject_set_int(&gDurationSubj, dur);
+    subject_set_int(&gPositionSubj, display_pos);
+
+    subject_set_int(&gPlayingSubj, med.isPlaying);
+    subject_set_int(&gShuffleSubj, med.shuffle);
+    subject_set_int(&gRepeatSubj, med.repeat);  // 0=off, 1=track, 2=context
+
+    // Show/hide artwork placeholder based on whether we have displayed artwork
+    if (!gArtworkDisplayed && musicUi.art_icon && lv_obj_has_flag(musicUi.art_icon, LV_OBJ_FLAG_HIDDEN)) {
+        // No artwork yet - show icon
+        lv_obj_remove_flag(musicUi.art_icon, LV_OBJ_FLAG_HIDDEN);
+        if (musicUi.art_img) lv_obj_add_flag(musicUi.art_img, LV_OBJ_FLAG_HIDDEN);
+    }
+}
 
-        // --- Update playlist/queue title ---
-        if (musicUi.playlist_label) {
-            if (med.hasPlaylist && strlen(med.playlist.name) > 0) {
-                lv_label_set_text(musicUi.playlist_label, med.playlist.name);
-            } else {
-                lv_label_set_text(musicUi.playlist_label, "Up Next");
-            }
-        }
+// --- Playlist/queue title ---
+static void update_playlist(const MediaData &med) {
+    subject_set_text(gPlaylistSubj, med.hasPlaylist && med.playlist.name[0] ? med.playlist.name : "Up Next");
+    if (musicUi.playlist_img) {
+        update_playlist_thumb(med);
+    }
+}
 
-        // --- Update queue list ---
-        if (musicUi.queue_list) {
-            // Check if queue changed
-            bool queueChanged = (med.queueLen != gLastQueueLen);
-            if (!queueChanged) {
-                for (uint8_t i = 0; i < med.queueLen && i < MAX_QUEUE_ITEMS; ++i) {
-                    if (strcmp(med.queue[i].name, gLastQueueItems[i]) != 0) {
-                        queueChanged = true;
-                        break;
-                    }
-                }
-            }
-            
-            if (queueChanged) {
-                lv_obj_clean(musicUi.queue_list);
-                
-                for (uint8_t i = 0; i < med.queueLen && i < MAX_QUEUE_ITEMS; ++i) {
-                    if (strlen(med.queue[i].name) == 0) continue;
-                    
-                    // Create queue item - simpler layout to avoid overlap
-                    // Layout: [Art 32px] [Text ~160px] [Play 32px] [Drag 28px]
-                    // Total width: ~280px (list is 294px)
-                    lv_obj_t *item_btn = lv_obj_create(musicUi.queue_list);
-                    lv_obj_remove_style_all(item_btn);
-                    lv_obj_set_size(item_btn, LV_PCT(100), 40);
-                    lv_obj_set_style_bg_color(item_btn, lv_color_hex(0x202040), 0);
-                    lv_obj_set_style_bg_opa(item_btn, LV_OPA_COVER, 0);
-                    lv_obj_set_style_radius(item_btn, 6, 0);
-                    lv_obj_set_style_pad_all(item_btn, 2, 0);
-                    lv_obj_remove_flag(item_btn, LV_OBJ_FLAG_SCROLLABLE);
-                    lv_obj_add_flag(item_btn, LV_OBJ_FLAG_CLICKABLE);
-                    // Store index on item for drag callback
-                    lv_obj_set_user_data(item_btn, (void*)(intptr_t)i);
-                    
-                    // === Artwork placeholder (left side) ===
-                    lv_obj_t *art_placeholder = lv_obj_create(item_btn);
-                    lv_obj_remove_style_all(art_placeholder);
-                    lv_obj_set_size(art_placeholder, 32, 32);
-                    lv_obj_align(art_placeholder, LV_ALIGN_LEFT_MID, 2, 0);
-                    lv_obj_set_style_bg_color(art_placeholder, lv_color_hex(0x303050), 0);
-                    lv_obj_set_style_bg_opa(art_placeholder, LV_OPA_COVER, 0);
-                    lv_obj_set_style_radius(art_placeholder, 4, 0);
-                    lv_obj_remove_flag(art_placeholder, LV_OBJ_FLAG_SCROLLABLE);
-                    lv_obj_remove_flag(art_placeholder, LV_OBJ_FLAG_CLICKABLE);
-                    
-                    // Music icon in placeholder
-                    lv_obj_t *art_icon = lv_label_create(art_placeholder);
-                    lv_label_set_text(art_icon, LV_SYMBOL_AUDIO);
-                    lv_obj_set_style_text_font(art_icon, &lv_font_montserrat_12, 0);
-                    lv_obj_set_style_text_color(art_icon, lv_color_hex(0x606080), 0);
-                    lv_obj_center(art_icon);
-                    
-                    // === Track info ===
-                    // Track name - single line, scrolls if too long
-                    lv_obj_t *name_label = lv_label_create(item_btn);
-                    lv_obj_add_style(name_label, &style_label_primary, 0);
-                    lv_label_set_text(name_label, med.queue[i].name);
-                    lv_obj_set_style_text_font(name_label, &lv_font_montserrat_10, 0);
-                    lv_label_set_long_mode(name_label, LV_LABEL_LONG_SCROLL_CIRCULAR);
-                    lv_obj_set_width(name_label, 180);  // Wider now without up/down buttons
-                    lv_obj_align(name_label, LV_ALIGN_LEFT_MID, 38, -8);
-                    
-                    // Artist name (single line, scrolls if too long)
-                    lv_obj_t *artist_label = lv_label_create(item_btn);
-                    lv_obj_add_style(artist_label, &style_label_secondary, 0);
-                    lv_label_set_text(artist_label, med.queue[i].artist);
-                    lv_obj_set_style_text_font(artist_label, &lv_font_montserrat_10, 0);
-                    lv_label_set_long_mode(artist_label, LV_LABEL_LONG_SCROLL_CIRCULAR);
-                    lv_obj_set_width(artist_label, 180);  // Wider now without up/down buttons
-                    lv_obj_align(artist_label, LV_ALIGN_LEFT_MID, 38, 8);
-                    
-                    // === Play button (Spotify only - plays this track immediately) ===
-                    lv_obj_t *play_btn = lv_button_create(item_btn);
-                    lv_obj_set_size(play_btn, 32, 32);
-                    lv_obj_align(play_btn, LV_ALIGN_RIGHT_MID, -36, 0);
-                    lv_obj_set_style_bg_color(play_btn, lv_color_hex(0x1db954), 0);
-                    lv_obj_set_style_radius(play_btn, 16, 0);
-                    lv_obj_set_style_pad_all(play_btn, 0, 0);
-                    lv_obj_t *play_icon = lv_label_create(play_btn);
-                    lv_label_set_text(play_icon, LV_SYMBOL_PLAY);
-                    lv_obj_set_style_text_font(play_icon, &lv_font_montserrat_12, 0);
-                    lv_obj_center(play_icon);
-                    lv_obj_set_user_data(play_btn, (void*)(intptr_t)i);
-                    lv_obj_add_event_cb(play_btn, queue_item_click_cb, LV_EVENT_CLICKED, NULL);
-                    
-                    // === Remove button (X) ===
-                    lv_obj_t *remove_btn = lv_button_create(item_btn);
-                    lv_obj_set_size(remove_btn, 32, 32);
-                    lv_obj_align(remove_btn, LV_ALIGN_RIGHT_MID, -2, 0);
-                    lv_obj_set_style_bg_color(remove_btn, lv_color_hex(0x802020), 0);
-                    lv_obj_set_style_radius(remove_btn, 4, 0);
-                    lv_obj_set_style_pad_all(remove_btn, 0, 0);
-                    lv_obj_t *remove_icon = lv_label_create(remove_btn);
-                    lv_label_set_text(remove_icon, LV_SYMBOL_CLOSE);
-                    lv_obj_set_style_text_font(remove_icon, &lv_font_montserrat_12, 0);
-                    lv_obj_center(remove_icon);
-                    lv_obj_set_user_data(remove_btn, (void*)(intptr_t)i);
-                    // TODO: Add remove callback if needed
-                    
-                    strncpy(gLastQueueItems[i], med.queue[i].name, MAX_STR_ESP - 1);
-                    gLastQueueItems[i][MAX_STR_ESP - 1] = '\0';
-                }
-                gLastQueueLen = med.queueLen;
+// --- Up Next list: rebuilt when its tracks change; true if it was rebuilt ---
+static bool update_queue(const MediaData &med) {
+    if (!musicUi.queue_list) return false;
+
+    // Check if queue changed
+    bool queueChanged = (med.queueLen != gLastQueueLen);
+    if (!queueChanged) {
+        for (uint8_t i = 0; i < med.queueLen && i < MAX_QUEUE_ITEMS; ++i) {
+            if (strcmp(med.queue[i].name, gLastQueueItems[i]) != 0) {
+                queueChanged = true;
+                break;
             }
         }
     }
-
-    // --- Discord Voice Call UI ---
-    // Three states: 1) Not connected (no Discord data), 2) Connected but not in call, 3) In call
-    if (med.hasDiscord) {
-        const DiscordState &dc = med.discord;
-        
-        // State change detection
-        bool stateChanged = (dc.inCall != discordUi.last_in_call) || 
-                           (!discordUi.last_connected && med.hasDiscord);
+    
+    if (queueChanged) {
+        lv_obj_clean(musicUi.queue_list);
+        memset(gQueueRowImg, 0, sizeof(gQueueRowImg));
+        memset(gQueueRowIcon, 0, sizeof(gQueueRowIcon));
         
-        if (stateChanged) {
-            discordUi.last_in_call = dc.inCall;
-            discordUi.last_connected = true;
+        for (uint8_t i = 0; i < med.queueLen && i < MAX_QUEUE_ITEMS; ++i) {
+            if (strlen(med.queue[i].name) == 0) continue;
             
-            if (dc.inCall) {
-                // State: IN CALL - show in_call_container
-                lv_obj_add_flag(discordUi.not_connected_container, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_add_flag(discordUi.not_in_call_container, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_remove_flag(discordUi.in_call_container, LV_OBJ_FLAG_HIDDEN);
-            } else {
-                // State: NOT IN CALL - show not_in_call_container
-                lv_obj_add_flag(discordUi.not_connected_container, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_remove_flag(discordUi.not_in_call_container, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_add_flag(discordUi.in_call_container, LV_OBJ_FLAG_HIDDEN);
-            }
-        }
-        
-        if (dc.inCall) {
-            // Update channel name with # prefix
-            if (strcmp(dc.channelName, discordUi.last_channel) != 0) {
-                strncpy(discordUi.last_channel, dc.channelName, DISCORD_CHANNEL_LEN - 1);
-                discordUi.last_channel[DISCORD_CHANNEL_LEN - 1] = '\0';
-                char chan_buf[DISCORD_CHANNEL_LEN + 4];
-                snprintf(chan_buf, sizeof(chan_buf), "# %s", dc.channelName);
-                lv_label_set_text(discordUi.channel_label, chan_buf);
-            }
+            // Create queue item - simpler layout to avoid overlap
+            // Layout: [Art 32px] [Text ~160px] [Play 32px] [Drag 28px]
+            // Total width: ~280px (list is 294px)
+            lv_obj_t *item_btn = lv_obj_create(musicUi.queue_list);
+            lv_obj_remove_style_all(item_btn);
+            lv_obj_set_size(item_btn, LV_PCT(100), 40);
+            lv_obj_set_style_bg_color(item_btn, lv_color_hex(0x202040), 0);
+            lv_obj_set_style_bg_opa(item_btn, LV_OPA_COVER, 0);
+            lv_obj_set_style_radius(item_btn, 6, 0);
+            lv_obj_set_style_pad_all(item_btn, 2, 0);
+            lv_obj_remove_flag(item_btn, LV_OBJ_FLAG_SCROLLABLE);
+            lv_obj_add_flag(item_btn, LV_OBJ_FLAG_CLICKABLE);
+            // Store index on item for drag callback
+            lv_obj_set_user_data(item_btn, (void*)(intptr_t)i);
             
-            // Update user list
-            uint8_t userCount = dc.userCount;
-            if (userCount > MAX_DISCORD_USERS) userCount = MAX_DISCORD_USERS;
+            // === Artwork placeholder (left side) ===
+            lv_obj_t *art_placeholder = lv_obj_create(item_btn);
+            lv_obj_remove_style_all(art_placeholder);
+            lv_obj_set_size(art_placeholder, 32, 32);
+            lv_obj_align(art_placeholder, LV_ALIGN_LEFT_MID, 2, 0);
+            lv_obj_set_style_bg_color(art_placeholder, lv_color_hex(0x303050), 0);
+            lv_obj_set_style_bg_opa(art_placeholder, LV_OPA_COVER, 0);
+            lv_obj_set_style_radius(art_placeholder, 4, 0);
+            lv_obj_remove_flag(art_placeholder, LV_OBJ_FLAG_SCROLLABLE);
+            lv_obj_remove_flag(art_placeholder, LV_OBJ_FLAG_CLICKABLE);
             
-            for (int i = 0; i < MAX_DISCORD_USERS; i++) {
-                if (i < userCount) {
-                    lv_obj_remove_flag(discordUi.users[i].container, LV_OBJ_FLAG_HIDDEN);
-                    
-                    // Update username
-                    lv_label_set_text(discordUi.users[i].name_label, dc.users[i].name);
-                    
-                    // Generate initials (first 2 chars, uppercase)
-                    char initials[3] = "??";
-                    if (strlen(dc.users[i].name) > 0) {
-                        initials[0] = toupper(dc.users[i].name[0]);
-                        if (strlen(dc.users[i].name) > 1) {
-                            initials[1] = toupper(dc.users[i].name[1]);
-                        } else {
-                            initials[1] = '\0';
-                        }
-                        initials[2] = '\0';
-                    }
-                    lv_label_set_text(discordUi.users[i].initials_label, initials);
-                    
-                    // Update status text based on speaking/muted/deafened
-                    if (dc.users[i].speaking) {
-                        lv_label_set_text(discordUi.users[i].status_label, "Speaking...");
-                        lv_obj_set_style_text_color(discordUi.users[i].status_label, lv_color_hex(DISCORD_GREEN), 0);
-                        // Green ring around avatar when speaking
-                        lv_obj_set_style_border_color(discordUi.users[i].avatar_circle, lv_color_hex(DISCORD_GREEN), 0);
-                        lv_obj_set_style_border_width(discordUi.users[i].avatar_circle, 2, 0);
-                    } else if (dc.users[i].deafened) {
-                        lv_label_set_text(discordUi.users[i].status_label, "Deafened");
-                        lv_obj_set_style_text_color(discordUi.users[i].status_label, lv_color_hex(DISCORD_RED), 0);
-                        lv_obj_set_style_border_width(discordUi.users[i].avatar_circle, 0, 0);
-                    } else if (dc.users[i].muted) {
-                        lv_label_set_text(discordUi.users[i].status_label, "Muted");
-                        lv_obj_set_style_text_color(discordUi.users[i].status_label, lv_color_hex(DISCORD_YELLOW), 0);
-                        lv_obj_set_style_border_width(discordUi.users[i].avatar_circle, 0, 0);
-                    } else {
-                        lv_label_set_text(discordUi.users[i].status_label, "");
-                        lv_obj_set_style_border_width(discordUi.users[i].avatar_circle, 0, 0);
-                    }
-                    
-                    // Update per-user mute/deaf button colors
-                    if (dc.users[i].muted) {
-                        lv_obj_set_style_bg_color(discordUi.users[i].mute_btn, lv_color_hex(DISCORD_RED), 0);
-                    } else {
-                        lv_obj_set_style_bg_color(discordUi.users[i].mute_btn, lv_color_hex(0x4F545C), 0);
-                    }
-                    if (dc.users[i].deafened) {
-                        lv_obj_set_style_bg_color(discordUi.users[i].deaf_btn, lv_color_hex(DISCORD_RED), 0);
-                    } else {
-                        lv_obj_set_style_bg_color(discordUi.users[i].deaf_btn, lv_color_hex(0x4F545C), 0);
-                    }
-                } else {
-                    lv_obj_add_flag(discordUi.users[i].container, LV_OBJ_FLAG_HIDDEN);
-                }
-            }
-            discordUi.last_user_count = userCount;
+            // Music icon in placeholder
+            lv_obj_t *art_icon = lv_label_create(art_placeholder);
+            lv_label_set_text(art_icon, LV_SYMBOL_AUDIO);
+            lv_obj_set_style_text_font(art_icon, &lv_font_montserrat_12, 0);
+            lv_obj_set_style_text_color(art_icon, lv_color_hex(0x606080), 0);
+            lv_obj_center(art_icon);
+
+            // Thumbnail from the atlas, shown once it has arrived
+            lv_obj_t *art_thumb = lv_image_create(art_placeholder);
+            lv_obj_set_size(art_thumb, QUEUE_THUMB_SIZE, QUEUE_THUMB_SIZE);
+            lv_obj_center(art_thumb);
+            lv_obj_add_flag(art_thumb, LV_OBJ_FLAG_HIDDEN);
+            strncpy(gQueueRowIds[i], med.queue[i].id, sizeof(gQueueRowIds[i]) - 1);
+            gQueueRowIds[i][sizeof(gQueueRowIds[i]) - 1] = '\0';
+            gQueueRowImg[i] = art_thumb;
+            gQueueRowIcon[i] = art_icon;
+            
+            // === Track info ===
+            // Track name - single line, scrolls if too long
+            lv_obj_t *name_label = lv_label_create(item_btn);
+            lv_obj_add_style(name_label, &style_label_primary, 0);
+            lv_label_set_text(name_label, med.queue[i].name);
+            lv_obj_set_style_text_font(name_label, &lv_font_montserrat_10, 0);
+            lv_label_set_long_mode(name_label, LV_LABEL_LONG_SCROLL_CIRCULAR);
+            lv_obj_set_width(name_label, 180);  // Wider now without up/down buttons
+            lv_obj_align(name_label, LV_ALIGN_LEFT_MID, 38, -8);
+            
+            // Artist name (single line, scrolls if too long)
+            lv_obj_t *artist_label = lv_label_create(item_btn);
+            lv_obj_add_style(artist_label, &style_label_secondary, 0);
+            lv_label_set_text(artist_label, med.queue[i].artist);
+            lv_obj_set_style_text_font(artist_label, &lv_font_montserrat_10, 0);
+            lv_label_set_long_mode(artist_label, LV_LABEL_LONG_SCROLL_CIRCULAR);
+            lv_obj_set_width(artist_label, 180);  // Wider now without up/down buttons
+            lv_obj_align(artist_label, LV_ALIGN_LEFT_MID, 38, 8);
+            
+            // === Play button (Spotify only - plays this track immediately) ===
+            lv_obj_t *play_btn = lv_button_create(item_btn);
+            lv_obj_set_size(play_btn, 32, 32);
+            lv_obj_align(play_btn, LV_ALIGN_RIGHT_MID, -36, 0);
+            lv_obj_set_style_bg_color(play_btn, lv_color_hex(0x1db954), 0);
+            lv_obj_set_style_radius(play_btn, 16, 0);
+            lv_obj_set_style_pad_all(play_btn, 0, 0);
+            lv_obj_t *play_icon = lv_label_create(play_btn);
+            lv_label_set_text(play_icon, LV_SYMBOL_PLAY);
+            lv_obj_set_style_text_font(play_icon, &lv_font_montserrat_12, 0);
+            lv_obj_center(play_icon);
+            lv_obj_set_user_data(play_btn, (void*)(intptr_t)i);
+            lv_obj_add_event_cb(play_btn, queue_item_click_cb, LV_EVENT_CLICKED, NULL);
+            
+            // === Remove button (X) ===
+            lv_obj_t *remove_btn = lv_button_create(item_btn);
+            lv_obj_set_size(remove_btn, 32, 32);
+            lv_obj_align(remove_btn, LV_ALIGN_RIGHT_MID, -2, 0);
+            lv_obj_set_style_bg_color(remove_btn, lv_color_hex(0x802020), 0);
+            lv_obj_set_style_radius(remove_btn, 4, 0);
+            lv_obj_set_style_pad_all(remove_btn, 0, 0);
+            lv_obj_t *remove_icon = lv_label_create(remove_btn);
+            lv_label_set_text(remove_icon, LV_SYMBOL_CLOSE);
+            lv_obj_set_style_text_font(remove_icon, &lv_font_montserrat_12, 0);
+            lv_obj_center(remove_icon);
+            lv_obj_set_user_data(remove_btn, (void*)(intptr_t)i);
+            // TODO: Add remove callback if needed
+            
+            strncpy(gLastQueueItems[i], med.queue[i].name, MAX_STR_ESP - 1);
+            gLastQueueItems[i][MAX_STR_ESP - 1] = '\0';
         }
-    } else {
-        // No Discord data - show "not connected" state
-        if (discordUi.last_connected || discordUi.last_in_call) {
-            discordUi.last_connected = false;
-            discordUi.last_in_call = false;
-            lv_obj_remove_flag(discordUi.not_connected_container, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_add_flag(discordUi.not_in_call_container, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_add_flag(discordUi.in_call_container, LV_OBJ_FLAG_HIDDEN);
+        gLastQueueLen = med.queueLen;
+    }
+    return queueChanged;
+}
+
+// --- Discord voice call ---
+static void update_discord(const MediaData &med) {
+    // Three states: 1) Not connected (no Discord data), 2) Connected but not in call, 3) In call
+    const DiscordState &dc = med.discord;
+    int32_t state = !med.hasDiscord ? DISCORD_UI_OFFLINE : (dc.inCall ? DISCORD_UI_IN_CALL : DISCORD_UI_IDLE);
+    subject_set_int(&gDiscordSubj, state);
+    if (state != DISCORD_UI_IN_CALL) return;
+
+    subject_set_text(gChannelSubj, dc.channelName);
+
+    uint8_t userCount = dc.userCount;
+    if (userCount > MAX_DISCORD_USERS) userCount = MAX_DISCORD_USERS;
+    for (int i = 0; i < MAX_DISCORD_USERS; i++) {
+        if (i >= userCount) {
+            subject_set_int(&gUserStatusSubj[i], DISCORD_USER_ABSENT);
+            continue;
         }
+        const DiscordUser &u = dc.users[i];
+        subject_set_text(gUserNameSubj[i], u.name);
+        subject_set_int(&gUserStatusSubj[i], (u.speaking ? DISCORD_USER_SPEAKING : 0) |
+                                             (u.muted ? DISCORD_USER_MUTED : 0) |
+                                             (u.deafened ? DISCORD_USER_DEAFENED : 0));
     }
 }
 
+void ui_update(const SystemData &sys, const MediaData &med, const ModelGens &gens) {
+    // Snapshots keep the usage history sampling, changed or not
+    if (sys.valid) gLastSystemMs = lv_tick_get();
+
+    // Only note where the latest state is: ui_frame_cb applies whatever
+    // changed since its last run, so a burst of snapshots costs one pass and
+    // nothing that arrives between runs is lost
+    gModelSys = &sys;
+    gModelMed = &med;
+    gModelGens = &gens;
+}
+
+// Every UPDATE_INTERVAL_MS: settings status, then the model domains that changed
+static void ui_frame_cb(lv_timer_t *t) {
+    (void)t;
+    uint32_t now = millis();
+
+    // --- Update network status in settings (every 2 seconds) ---
+    static uint32_t lastNetUpdate = 0;
+    if (now - lastNetUpdate > 2000) {
+        lastNetUpdate = now;
+        update_wifi_status_display();
+    }
+    
+    // --- Check for scan completion ---
+    if (settingsUi.scan_pending && wifiMgr.isScanComplete()) {
+        settingsUi.scan_pending = false;
+        lv_label_set_text(lv_obj_get_child(settingsUi.scan_btn, 0), LV_SYMBOL_REFRESH " Scan Networks");
+        update_network_list();
+    }
+
+    if (!gModelSys) return;  // No snapshot yet
+    const SystemData &sys = *gModelSys;
+    const MediaData &med = *gModelMed;
+
+    // Only the domains that changed since the last pass are touched
+    uint8_t dirty = model_take_dirty(*gModelGens, gUiSeen);
+
+    // Music domains only apply with media (a structural change can arrive
+    // before the telemetry that says so): keep them pending until then
+    if (!med.valid) {
+        gUiSeen.gen[DOMAIN_PLAYBACK] = 0;
+        gUiSeen.gen[DOMAIN_QUEUE] = 0;
+        gUiSeen.gen[DOMAIN_PLAYLIST] = 0;
+    }
+
+    // --- New artwork (published by the ingest task into the back buffer) ---
+    if (dirty & DOMAIN_BIT(DOMAIN_ARTWORK)) update_artwork();
+
+    if (dirty & DOMAIN_BIT(DOMAIN_SYSTEM)) update_system(sys);
+
+    // --- Music ---
+    if (med.valid) {
+        if (dirty & DOMAIN_BIT(DOMAIN_PLAYBACK)) update_playback(med);
+        if (dirty & DOMAIN_BIT(DOMAIN_PLAYLIST)) update_playlist(med);
+        bool queueRebuilt = (dirty & DOMAIN_BIT(DOMAIN_QUEUE)) && update_queue(med);
+
+        // Thumbnails come on their own lines: checked on every pass
+        uint32_t thumbGen = queue_thumbs_generation();
+        if (musicUi.queue_list && (queueRebuilt || thumbGen != gLastThumbGen)) {
+            refresh_queue_thumbs(thumbGen != gLastThumbGen);
+            gLastThumbGen = thumbGen;
+        }
+    }
+
+    if (dirty & DOMAIN_BIT(DOMAIN_DISCORD)) update_discord(med);
+}
+
 // Smoothly interpolate progress bar between server updates
 static uint32_t gLastTickMs = 0;
 
@@ -1981,7 +2300,7 @@ void ui_tick() {
     gLastTickMs = now_ms;
     
     // Only interpolate if playing
-    if (musicUi.is_playing && musicUi.last_server_duration > 0) {
+    if (lv_subject_get_int(&gPlayingSubj) && musicUi.last_server_duration > 0) {
         // Add elapsed time to interpolated position (convert ms to seconds)
         int elapsed_sec = elapsed_ms / 1000;
         if (elapsed_ms % 1000 >= 500) elapsed_sec++;  // Round
@@ -1999,27 +2318,24 @@ void ui_tick() {
             musicUi.interpolated_position = musicUi.last_server_duration;
         }
         
-        // Update progress bar display
-        if (musicUi.progress_bar) {
-            lv_bar_set_value(musicUi.progress_bar, musicUi.interpolated_position, LV_ANIM_OFF);
-        }
-        
-        // Update time label
-        if (musicUi.progress_label) {
-            char pos_str[16], dur_str[16], buf[48];
-            format_time(pos_str, sizeof(pos_str), musicUi.interpolated_position);
-            format_time(dur_str, sizeof(dur_str), musicUi.last_server_duration);
-            snprintf(buf, sizeof(buf), "%s / %s", pos_str, dur_str);
-            lv_label_set_text(musicUi.progress_label, buf);
+        // Bar and time label follow the subject (redrawn once per second)
+        subject_set_int(&gPositionSubj, musicUi.interpolated_position);
+    }
+}
+void ui_drain_events() {
+    UiEvent ev;
+    while (ui_event_take(ev)) {
+        switch (ev.type) {
+            case UI_EVENT_PLAY_STATE:
+                ui_set_play_state(ev.value != 0);
+                break;
         }
     }
 }
+
 // External API: set the play state and update UI accordingly
 void ui_set_play_state(bool is_playing) {
-    musicUi.is_playing = is_playing;
-    if (musicUi.play_pause_label) {
-        lv_label_set_text(musicUi.play_pause_label, musicUi.is_playing ? LV_SYMBOL_PAUSE : LV_SYMBOL_PLAY);
-    }
+    subject_set_int(&gPlayingSubj, is_playing);
     Serial.print("[UI] ACK play_state=");
-    Serial.println(musicUi.is_playing ? "1" : "0");
+    Serial.println(is_playing ? "1" : "0");
 }
\ No newline at end of file
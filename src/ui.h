@@ -5,11 +5,17 @@
 // Initialize LVGL UI (tabview, styles, widgets)
 void ui_init();
 
-// Update UI elements from the latest data models
-void ui_update(const SystemData &sys, const MediaData &med);
+// Hand the UI the latest data models. Nothing is drawn here: an lv_timer
+// applies the domains that changed at most every 100 ms. The objects must
+// stay valid and are re-read on every pass (loop() keeps them static).
+void ui_update(const SystemData &sys, const MediaData &med, const ModelGens &gens);
 
-// Set play/pause state programmatically (used for ack from server)
+// Set play/pause state programmatically (LVGL thread only)
 void ui_set_play_state(bool is_playing);
 
+// Apply the events the ingest task posted (ui_event_post). Call from loop()
+// right before lv_timer_handler() so they show in the same frame.
+void ui_drain_events();
+
 // Call frequently (e.g., in main loop) to smoothly interpolate progress bar
 void ui_tick();